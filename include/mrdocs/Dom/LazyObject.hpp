@@ -14,7 +14,16 @@
 #include <mrdocs/Platform.hpp>
 #include <mrdocs/Dom.hpp>
 #include <mrdocs/Support/Error.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace mrdocs::dom {
 
@@ -36,6 +45,53 @@ namespace detail
     /* A helper empty struct
      */
     struct NoLazyObjectContext { };
+
+    /* The keys of the lazy objects of a type
+
+       Each key gets a dense slot number the first
+       time an object of the type maps it, so objects
+       store slot numbers instead of strings.
+
+       Lookups read an immutable snapshot of the
+       table and don't take a lock. A new snapshot
+       is published when a new key is found, which
+       only happens while objects are indexed.
+     */
+    class MRDOCS_DECL LazyObjectKeys
+    {
+        struct Table
+        {
+            std::unordered_map<std::string_view, std::uint32_t> slots;
+            std::vector<std::string_view> names;
+        };
+
+        std::atomic<Table const*> table_;
+        std::mutex mutex_;
+        std::deque<std::string> storage_;
+        std::vector<std::unique_ptr<Table>> tables_;
+
+    public:
+        static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+        LazyObjectKeys();
+
+        ~LazyObjectKeys();
+
+        /* Return the slot of a key, or npos
+         */
+        std::uint32_t
+        find(std::string_view key) const;
+
+        /* Return the slot of a key, adding the key if needed
+         */
+        std::uint32_t
+        insert(std::string_view key);
+
+        /* Return the key of a slot
+         */
+        std::string_view
+        name(std::uint32_t slot) const;
+    };
 }
 
 /** Customization point tag.
@@ -131,12 +187,23 @@ concept HasLazyObjectMap =
 
     When any of the object properties are accessed,
     the object @ref dom::Value is constructed.
-    In practice, the object never takes any memory
-    besides the pointer to the underlying object.
+    The object only stores a pointer to the
+    underlying object, the slots of its keys,
+    and the values converted so far.
 
     The keys and values in the underlying object
     should be mapped using `tag_invoke`.
 
+    The object is indexed the first time it is
+    accessed: each key is mapped to a slot in a
+    hashed table shared by all objects of the type,
+    and the mapped values are converted. Deferred
+    values are converted the first time they are
+    accessed. Repeated accesses to the same key
+    return the memoized value, so the values of
+    the underlying object should not change after
+    the object is accessed.
+
     This class is typically useful for
     implementing objects that are expensive
     and have recursive dependencies, as these
@@ -162,22 +229,67 @@ template <class T, class Context = detail::NoLazyObjectContext>
 requires HasLazyObjectMap<T, Context>
 class LazyObjectImpl : public ObjectImpl
 {
+    /* A key of the underlying object in mapping order
+     */
+    struct Entry
+    {
+        std::uint32_t key = 0;
+        bool deferred = false;
+        std::once_flag converted;
+        Value value;
+    };
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
     T const* underlying_;
     Object overlay_;
     MRDOCS_NO_UNIQUE_ADDRESS Context context_{};
+    detail::LazyObjectKeys* keys_;
+
+    mutable std::once_flag indexed_;
+    mutable std::unique_ptr<Entry[]> entries_;
+    mutable std::size_t size_ = 0;
+    mutable bool hasDeferred_ = false;
+
+    // The position in entries_ plus one for
+    // each key slot, or zero if not mapped
+    mutable std::vector<std::uint32_t> positions_;
+
+    static
+    detail::LazyObjectKeys&
+    typeKeys();
+
+    template <class IO>
+    void
+    mapUnderlying(IO& io) const;
+
+    template <class U>
+    Value
+    convert(U const& value) const;
+
+    void
+    buildIndex() const;
+
+    std::size_t
+    indexOf(std::string_view key) const;
+
+    Value
+    convertAt(std::size_t i) const;
 
 public:
     explicit
     LazyObjectImpl(T const& obj)
         requires HasLazyObjectMapWithoutContext<T>
         : underlying_(&obj)
-        , context_{} {}
+        , context_{}
+        , keys_(&typeKeys()) {}
 
     explicit
     LazyObjectImpl(T const& obj, Context const& context)
         requires HasLazyObjectMapWithContext<T, Context>
         : underlying_(&obj)
-        , context_(context) {}
+        , context_(context)
+        , keys_(&typeKeys()) {}
 
     ~LazyObjectImpl() override = default;
 
@@ -272,16 +384,21 @@ namespace detail
 
 template <class T, class Context>
 requires HasLazyObjectMap<T, Context>
-std::size_t
+detail::LazyObjectKeys&
 LazyObjectImpl<T, Context>::
-size() const
+typeKeys()
+{
+    static detail::LazyObjectKeys keys;
+    return keys;
+}
+
+template <class T, class Context>
+requires HasLazyObjectMap<T, Context>
+template <class IO>
+void
+LazyObjectImpl<T, Context>::
+mapUnderlying(IO& io) const
 {
-    std::size_t result = 0;
-    detail::LazyObjectIO io(
-        [&result, this](std::string_view name, auto const& /* value or deferred */)
-        {
-            result += !overlay_.exists(name);
-        });
     if constexpr (HasLazyObjectMapWithContext<T, Context>)
     {
         tag_invoke(LazyObjectMapTag{}, io, *underlying_, context_);
@@ -290,37 +407,154 @@ size() const
     {
         tag_invoke(LazyObjectMapTag{}, io, *underlying_);
     }
-    return result + overlay_.size();
 }
 
 template <class T, class Context>
 requires HasLazyObjectMap<T, Context>
-bool
+template <class U>
+Value
 LazyObjectImpl<T, Context>::
-exists(std::string_view key) const
+convert(U const& value) const
 {
-    if (overlay_.exists(key))
+    if constexpr (HasValueFromWithContext<U, Context>)
     {
-        return true;
+        return dom::ValueFrom(value, context_);
+    }
+    else
+    {
+        return dom::ValueFrom(value);
     }
-    bool result = false;
-    detail::LazyObjectIO io(
-        [&result, key](std::string_view name, auto const& /* value or deferred */)
+}
+
+template <class T, class Context>
+requires HasLazyObjectMap<T, Context>
+void
+LazyObjectImpl<T, Context>::
+buildIndex() const
+{
+    std::call_once(indexed_, [this]
     {
-        if (!result && name == key)
+        // Mapped values are converted in this pass,
+        // because the mapping might pass temporaries
+        // that don't outlive it
+        struct Mapped
+        {
+            std::uint32_t key;
+            bool deferred;
+            Value value;
+        };
+        std::vector<Mapped> mapped;
+        detail::LazyObjectIO io(
+            [&](std::string_view name, auto const& value)
+            {
+                mapped.push_back({keys_->insert(name), false, convert(value)});
+            }, [&](std::string_view name, auto const& /* deferred */)
+            {
+                mapped.push_back({keys_->insert(name), true, {}});
+            });
+        mapUnderlying(io);
+
+        auto entries = std::make_unique<Entry[]>(mapped.size());
+        std::vector<std::uint32_t> positions;
+        bool hasDeferred = false;
+        for (std::size_t i = 0; i < mapped.size(); ++i)
         {
-            result = true;
+            Entry& entry = entries[i];
+            entry.key = mapped[i].key;
+            entry.deferred = mapped[i].deferred;
+            entry.value = std::move(mapped[i].value);
+            hasDeferred = hasDeferred || entry.deferred;
+            if (entry.key >= positions.size())
+            {
+                positions.resize(entry.key + 1, 0);
+            }
+            // The first mapping of a key wins
+            if (positions[entry.key] == 0)
+            {
+                positions[entry.key] = static_cast<std::uint32_t>(i + 1);
+            }
         }
+        entries_ = std::move(entries);
+        size_ = mapped.size();
+        hasDeferred_ = hasDeferred;
+        positions_ = std::move(positions);
     });
-    if constexpr (HasLazyObjectMapWithContext<T, Context>)
+}
+
+template <class T, class Context>
+requires HasLazyObjectMap<T, Context>
+std::size_t
+LazyObjectImpl<T, Context>::
+indexOf(std::string_view key) const
+{
+    buildIndex();
+    std::uint32_t const slot = keys_->find(key);
+    if (slot >= positions_.size() ||
+        positions_[slot] == 0)
     {
-        tag_invoke(LazyObjectMapTag{}, io, *underlying_, context_);
+        return npos;
     }
-    else
+    return positions_[slot] - 1;
+}
+
+template <class T, class Context>
+requires HasLazyObjectMap<T, Context>
+Value
+LazyObjectImpl<T, Context>::
+convertAt(std::size_t i) const
+{
+    Entry& entry = entries_[i];
+    if (entry.deferred)
     {
-        tag_invoke(LazyObjectMapTag{}, io, *underlying_);
+        // The deferred function can't be stored,
+        // as it might refer to the arguments of
+        // the mapping, so it's found again
+        std::call_once(entry.converted, [&]
+        {
+            std::size_t idx = 0;
+            detail::LazyObjectIO io(
+                [&](std::string_view, auto const&)
+                {
+                    ++idx;
+                }, [&](std::string_view, auto const& deferred)
+                {
+                    if (idx++ == i)
+                    {
+                        entry.value = convert(deferred());
+                    }
+                });
+            mapUnderlying(io);
+        });
     }
-    return result;
+    return entry.value;
+}
+
+template <class T, class Context>
+requires HasLazyObjectMap<T, Context>
+std::size_t
+LazyObjectImpl<T, Context>::
+size() const
+{
+    buildIndex();
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+        result += !overlay_.exists(keys_->name(entries_[i].key));
+    }
+    return result + overlay_.size();
+}
+
+template <class T, class Context>
+requires HasLazyObjectMap<T, Context>
+bool
+LazyObjectImpl<T, Context>::
+exists(std::string_view key) const
+{
+    if (overlay_.exists(key))
+    {
+        return true;
+    }
+    return indexOf(key) != npos;
 }
 
 
@@ -334,44 +568,12 @@ get(std::string_view key) const
     {
         return overlay_.get(key);
     }
-    Value result;
-    detail::LazyObjectIO io(
-        [&result, key, this](std::string_view name, auto const& value)
-        {
-            if (result.isUndefined() && name == key)
-            {
-                if constexpr (HasValueFromWithContext<std::remove_cvref_t<decltype(value)>, Context>)
-                {
-                    ValueFrom(value, context_, result);
-                }
-                else
-                {
-                    ValueFrom(value, result);
-                }
-            }
-        }, [&result, key, this](std::string_view name, auto const& deferred)
-        {
-            if (result.isUndefined() && name == key)
-            {
-                if constexpr (HasValueFromWithContext<std::remove_cvref_t<decltype(deferred())>, Context>)
-                {
-                    ValueFrom(deferred(), context_, result);
-                }
-                else
-                {
-                    ValueFrom(deferred(), result);
-                }
-            }
-        });
-    if constexpr (HasLazyObjectMapWithContext<T, Context>)
+    std::size_t const i = indexOf(key);
+    if (i == npos)
     {
-        tag_invoke(LazyObjectMapTag{}, io, *underlying_, context_);
-    }
-    else
-    {
-        tag_invoke(LazyObjectMapTag{}, io, *underlying_);
+        return {};
     }
-    return result;
+    return convertAt(i);
 }
 
 template <class T, class Context>
@@ -389,42 +591,49 @@ bool
 LazyObjectImpl<T, Context>::
 visit(std::function<bool(String, Value)> fn) const
 {
+    buildIndex();
     bool visitMore = true;
-    detail::LazyObjectIO io(
-        [&visitMore, &fn, this](std::string_view name, auto const& value)
+    auto visitEntry = [&](std::size_t i)
+    {
+        Entry const& entry = entries_[i];
+        std::string_view const name = keys_->name(entry.key);
+        if (!visitMore || overlay_.exists(name))
         {
-            if (visitMore && !overlay_.exists(name))
-            {
-                if constexpr (HasValueFromWithContext<std::remove_cvref_t<decltype(value)>, Context>)
-                {
-                    visitMore = fn(name, dom::ValueFrom(value, context_));
-                }
-                else
-                {
-                    visitMore = fn(name, dom::ValueFrom(value));
-                }
-            }
-        }, [&visitMore, &fn, this](std::string_view name, auto const& deferred)
+            return;
+        }
+        visitMore = fn(name, entry.value);
+    };
+    if (!hasDeferred_)
+    {
+        for (std::size_t i = 0; i < size_ && visitMore; ++i)
         {
-            if (visitMore && !overlay_.exists(name))
+            visitEntry(i);
+        }
+    }
+    else
+    {
+        // Deferred values not converted yet are
+        // converted in a single pass
+        std::size_t idx = 0;
+        detail::LazyObjectIO io(
+            [&](std::string_view, auto const&)
+            {
+                visitEntry(idx++);
+            }, [&](std::string_view name, auto const& deferred)
             {
-                if constexpr (HasValueFromWithContext<std::remove_cvref_t<decltype(deferred())>, Context>)
+                std::size_t const i = idx++;
+                if (!visitMore || overlay_.exists(name))
                 {
-                    visitMore = fn(name, dom::ValueFrom(deferred(), context_));
+                    return;
                 }
-                else
+                Entry& entry = entries_[i];
+                std::call_once(entry.converted, [&]
                 {
-                    visitMore = fn(name, dom::ValueFrom(deferred()));
-                }
-            }
-        });
-    if constexpr (HasLazyObjectMapWithContext<T, Context>)
-    {
-        tag_invoke(LazyObjectMapTag{}, io, *underlying_, context_);
-    }
-    else
-    {
-        tag_invoke(LazyObjectMapTag{}, io, *underlying_);
+                    entry.value = convert(deferred());
+                });
+                visitEntry(i);
+            });
+        mapUnderlying(io);
     }
     return visitMore && overlay_.visit(fn);
 }
@@ -86,6 +86,11 @@ public:
 
     /** Return a Dom object representing the given symbol.
 
+        Objects are cached, so requesting the same
+        symbol again returns the same object, even
+        from other threads. Callers should not
+        modify the returned object.
+
         @return A value containing the symbol
         contents, or null if `id` is invalid.
 
@@ -14,6 +14,7 @@
 #include <mrdocs/Platform.hpp>
 #include <mrdocs/Metadata/Symbol.hpp>
 #include <mrdocs/Metadata/Symbol/Function.hpp>
+#include <span>
 
 namespace mrdocs {
 
@@ -39,6 +40,17 @@ struct OverloadsSymbol final
      */
     Polymorphic<Type> ReturnType = Polymorphic<Type>(AutoType{});
 
+    /** An order-independent fingerprint of the members.
+
+        This is the sum of the hashes of the member IDs,
+        kept up to date as members are added. Overload
+        sets with the same members always have the same
+        fingerprint, regardless of the order of the members.
+
+        @see hashOverloadMembers
+     */
+    std::size_t MembersHash = 0;
+
     //--------------------------------------------
 
     explicit OverloadsSymbol(SymbolID const& ID) noexcept
@@ -64,6 +76,17 @@ MRDOCS_DECL
 void
 addMember(OverloadsSymbol& I, FunctionSymbol const& Member);
 
+/** Return the order-independent fingerprint of a set of members.
+
+    The result is the value @ref OverloadsSymbol::MembersHash
+    would have for an overload set with these members.
+
+    @param ids The member IDs.
+ */
+MRDOCS_DECL
+std::size_t
+hashOverloadMembers(std::span<SymbolID const> ids) noexcept;
+
 /** Map a OverloadsSymbol to a dom::Object.
 
     @param t The tag type.
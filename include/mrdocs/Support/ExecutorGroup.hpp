@@ -15,7 +15,6 @@
 #include <mrdocs/Support/Error.hpp>
 #include <mrdocs/Support/ThreadPool.hpp>
 #include <mrdocs/Support/any_callable.hpp>
-#include <deque>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -26,8 +25,6 @@ namespace mrdocs {
 class MRDOCS_DECL
     ExecutorGroupBase
 {
-    class scoped_agent;
-
 protected:
     struct Impl;
 
@@ -39,12 +36,10 @@ protected:
     };
 
     std::unique_ptr<Impl> impl_;
-    std::vector<std::unique_ptr<AnyAgent>> agents_;
-    std::deque<any_callable<void(void*)>> work_;
 
     explicit ExecutorGroupBase(ThreadPool&);
+    void add(std::unique_ptr<AnyAgent>);
     void post(any_callable<void(void*)>);
-    void run(std::unique_lock<std::mutex>);
 
 public:
     template<class T>
@@ -66,6 +61,11 @@ public:
 //------------------------------------------------
 
 /** A set of execution agents for performing concurrent work.
+
+    Each agent runs on at most one thread at a time.
+    Work submitted from a running agent is queued
+    locally to that agent, and agents which run out
+    of work steal from the queues of the others.
 */
 template<class Agent>
 class ExecutorGroup : public ExecutorGroupBase
@@ -106,9 +106,8 @@ public:
     void
     emplace(Args&&... args)
     {
-        agents_.emplace_back(
-            std::make_unique<AgentImpl>(
-                std::forward<Args>(args)...));
+        add(std::make_unique<AgentImpl>(
+            std::forward<Args>(args)...));
     }
 
     /** Submit work to be executed.
@@ -15,6 +15,9 @@
 #include <mrdocs/Support/String.hpp>
 #include <format>
 #include <functional>
+#include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <type_traits>
 #include <unordered_map>
@@ -130,9 +133,23 @@ class MRDOCS_DECL OutputRef
         , fptr_( &noop_output )
     {}
 
+    // Write with indentation after each newline
     OutputRef&
     write_impl( std::string_view sv );
 
+    // Write to output. Unindented output, the
+    // common case, goes directly to the output.
+    OutputRef&
+    write( std::string_view sv )
+    {
+        if (indent_ == 0)
+        {
+            fptr_( out_, sv );
+            return *this;
+        }
+        return write_impl( sv );
+    }
+
 public:
     /** Constructor for std::string output
 
@@ -182,7 +199,7 @@ public:
     OutputRef&
     operator<<( OutputRef& os, std::string_view sv )
     {
-        return os.write_impl( sv );
+        return os.write( sv );
     }
 
     /** Write to output
@@ -195,7 +212,7 @@ public:
     OutputRef&
     operator<<( OutputRef& os, char c )
     {
-        return os.write_impl( std::string_view( &c, 1 ) );
+        return os.write( std::string_view( &c, 1 ) );
     }
 
     /** Write to output
@@ -208,7 +225,7 @@ public:
     OutputRef&
     operator<<( OutputRef& os, char const * c )
     {
-        return os.write_impl( std::string_view( c ) );
+        return os.write( std::string_view( c ) );
     }
 
     /** Write to output
@@ -221,7 +238,7 @@ public:
       requires std::formattable<T, char>
     friend OutputRef &operator<<(OutputRef &os, T v) {
       std::string s = std::format("{}", v);
-      return os.write_impl(s);
+      return os.write(s);
     }
 
     void
@@ -237,6 +254,71 @@ public:
     }
 };
 
+/** A buffer that writes to an output in large chunks
+
+    Templates produce many small fragments, such as
+    single escaped characters and short literals.
+    An @ref OutputRef to this buffer collects the
+    fragments and writes them to the underlying
+    output only when the buffer is full, when it is
+    flushed, or when it is destroyed.
+
+    Output written to the underlying output by other
+    means while the buffer is in use must be preceded
+    by a call to @ref flush.
+ */
+class MRDOCS_DECL OutputBuffer
+{
+    OutputRef out_;
+    std::string buf_;
+    std::size_t capacity_;
+
+public:
+    /// The character type, as for std::string
+    using value_type = char;
+
+    /// The default capacity of the buffer
+    static constexpr std::size_t defaultCapacity = 64 * 1024;
+
+    /** Constructor
+
+        @param out The output to write to
+        @param capacity The size of the chunks written to the output
+     */
+    explicit
+    OutputBuffer(
+        OutputRef out,
+        std::size_t capacity = defaultCapacity);
+
+    /** Destructor
+
+        The buffered output is written to the output.
+        Errors from the output are ignored, so callers
+        should call @ref flush to detect them.
+     */
+    ~OutputBuffer();
+
+    OutputBuffer(OutputBuffer const&) = delete;
+    OutputBuffer& operator=(OutputBuffer const&) = delete;
+
+    /** Append to the buffer
+
+        Strings larger than the capacity are written
+        directly to the output after the buffered
+        contents.
+
+        @param first The first character to append
+        @param last One past the last character to append
+     */
+    void
+    append(char const* first, char const* last);
+
+    /** Write the buffered output to the output
+     */
+    void
+    flush();
+};
+
 /** HTML escapes the specified string
 
     This function HTML escapes the specified string, making it safe for
@@ -466,6 +548,7 @@ struct HandlebarsOptions
 
 namespace detail {
     struct RenderState;
+    struct CompiledTemplate;
 
     // Heterogeneous lookup support
     struct string_hash {
@@ -488,6 +571,101 @@ namespace detail {
         std::string, std::string_view, string_hash, std::equal_to<>>;
 }
 
+/** A compiled handlebars template
+
+    This class holds a template whose tags have been found
+    and parsed ahead of time by @ref Handlebars::compile.
+
+    Rendering a compiled template produces the same output as
+    rendering its text, but the template is only tokenized
+    once. Tags, block boundaries, and standalone whitespace
+    decisions are looked up instead of recomputed on every
+    render, which is what dominates the cost of rendering
+    the same template for many different contexts.
+
+    A compiled template is immutable and does not depend on
+    the environment that compiled it. Copies share the same
+    representation, and the template can be rendered by any
+    number of threads or environments concurrently.
+
+    @see Handlebars::compile
+ */
+class MRDOCS_DECL HandlebarsTemplate
+{
+    friend class Handlebars;
+    std::shared_ptr<detail::CompiledTemplate const> impl_;
+
+public:
+    /** Construct an empty template
+     */
+    HandlebarsTemplate() noexcept = default;
+
+    /** Return the template text
+     */
+    std::string_view
+    text() const noexcept;
+};
+
+/** A cache of rendered partials
+
+    When an environment has a fragment cache, the output of
+    registered partials is memoized by the key the cache
+    computes for each call. A partial whose output only
+    depends on the values in its key is rendered once and
+    copied for all other calls with the same key.
+
+    The cache decides which partials are cacheable: an empty
+    key means the partial should be rendered as usual.
+    Partial blocks, inline partials, partials with hash
+    arguments, and indented partials are never cached.
+
+    The same cache can be shared by many environments, so
+    implementations should be safe to call from multiple
+    threads.
+
+    @see Handlebars::setFragmentCache
+ */
+class MRDOCS_DECL HandlebarsFragmentCache
+{
+public:
+    /** Destructor
+     */
+    virtual ~HandlebarsFragmentCache() = default;
+
+    /** Return the key for rendering a partial
+
+        @param partialName The name of the partial
+        @param context The context of the partial
+        @param root The root context of the template
+        @return The key identifying the rendered output,
+        or an empty string if the output should not be
+        cached.
+     */
+    virtual
+    std::string
+    key(
+        std::string_view partialName,
+        dom::Value const& context,
+        dom::Value const& root) = 0;
+
+    /** Return the fragment rendered for a key, if any
+
+        @param key The key returned by @ref key
+     */
+    virtual
+    std::optional<std::string>
+    find(std::string_view key) = 0;
+
+    /** Store the fragment rendered for a key
+
+        @param key The key returned by @ref key
+        @param fragment The rendered partial
+     */
+    virtual
+    void
+    insert(std::string key, std::string fragment) = 0;
+};
+
 /** A handlebars environment
 
     This class implements a handlebars template environment.
@@ -559,22 +737,24 @@ namespace detail {
 
     Compiled templates:
 
-    Unlike handlebars.js, this implementation renders the template
-    directly to the output stream, without requiring an intermediary
-    object to store a representation of the compiled template
-    (`Handlebars.precompile`) or an intermediary callable object
-    required to ultimately render the template (`Handlebars.precompile`).
-
-    The rationale is that there is not much benefit in pre-compiling templates
-    in C++, since both iterating the input string and a pre-compiled template
-    would have very similar costs even in optimal implementations of the
-    compiled template.
-
-    The most significant benefit of pre-compiling templates in C++ would
-    be the faster identification of the ends of blocks, which would
-    allow the engine iterate the block only once. For this reason,
-    compiled templates will still be considered in a future version
-    of this sub-library.
+    Like handlebars.js, this implementation can render a template
+    directly from its text or from a compiled template created with
+    `compile`. Unlike handlebars.js, the compiled template is not
+    a callable object but an immutable @ref HandlebarsTemplate
+    passed to the same `render` functions.
+
+    The compiled template stores the tags found in the text, their
+    parsed contents, their standalone whitespace decisions, and the
+    delimiters of each block. The most significant benefit is the
+    faster identification of the ends of blocks, which allows the
+    engine to skip over the contents of a block instead of scanning
+    them again every time the block is rendered.
+
+    Rendering a compiled template falls back to scanning the text
+    whenever the compiled representation cannot answer for the
+    range being rendered, such as inline partials, so the output
+    is always identical to the output of rendering the text.
+    Registered partials are compiled when they are registered.
 
     Also note that compiled templates cannot avoid exceptions, because
     a compiled template can still invoke a helper that throws exceptions
@@ -634,10 +814,13 @@ class Handlebars {
     using helpers_map = std::unordered_map<
         std::string, dom::Function, detail::string_hash, std::equal_to<>>;
 
-    using partials_map = detail::partials_map;
+    using partials_map = std::unordered_map<
+        std::string, HandlebarsTemplate, detail::string_hash, std::equal_to<>>;
+
     partials_map partials_;
     helpers_map helpers_;
     dom::Function logger_;
+    std::shared_ptr<HandlebarsFragmentCache> fragmentCache_;
 
 public:
     /** Construct a handlebars environment
@@ -840,6 +1023,117 @@ public:
         return try_render_to(out, templateText, context, {});
     }
 
+    /** Compile a handlebars template
+
+        This function finds and parses all tags in the template
+        text ahead of time so that the template can be rendered
+        many times without tokenizing the text again.
+
+        The compiled template holds a copy of the text and does not
+        depend on the environment. Helpers and partials are resolved
+        when the template is rendered.
+
+        @code{.cpp}
+          Handlebars env;
+          HandlebarsTemplate tpl = Handlebars::compile("{{ foo }}");
+          dom::Object context;
+          context["foo"] = "bar";
+          std::string result = env.render(tpl, context);
+          assert(result == "bar");
+        @endcode
+
+        @param templateText The handlebars template text
+        @return The compiled template
+     */
+    static
+    HandlebarsTemplate
+    compile(std::string_view templateText);
+
+    /** Render a compiled handlebars template
+
+        This function renders the compiled template and returns
+        the result as a string. The result is the same as rendering
+        the text the template was compiled from.
+
+        @param compiled The compiled template
+        @param context The data to render
+        @param options The options to use
+        @return The rendered text
+     */
+    std::string
+    render(
+        HandlebarsTemplate const& compiled,
+        dom::Value const& context,
+        HandlebarsOptions const& options) const
+    {
+        auto exp = try_render(compiled, context, options);
+        if (!exp)
+        {
+            throw exp.error();
+        }
+        return *exp;
+    }
+
+    /// @overload
+    std::string
+    render(
+        HandlebarsTemplate const& compiled,
+        dom::Value const& context) const
+    {
+        return render(compiled, context, {});
+    }
+
+    /** Render a compiled handlebars template
+
+        This function renders the compiled template and writes
+        the result to the specified output stream.
+
+        @param out The output stream
+        @param compiled The compiled template
+        @param context The data to render
+        @param options The options to use
+     */
+    void
+    render_to(
+        OutputRef& out,
+        HandlebarsTemplate const& compiled,
+        dom::Value const& context,
+        HandlebarsOptions const& options) const
+    {
+        auto exp = try_render_to(out, compiled, context, options);
+        if (!exp)
+        {
+            throw exp.error();
+        }
+    }
+
+    /** @copydoc render(HandlebarsTemplate const&, dom::Value const&, HandlebarsOptions const&) const
+     */
+    Expected<std::string, HandlebarsError>
+    try_render(
+        HandlebarsTemplate const& compiled,
+        dom::Value const& context,
+        HandlebarsOptions const& options) const
+    {
+        std::string out;
+        OutputRef os(out);
+        auto exp = try_render_to(os, compiled, context, options);
+        if (!exp)
+        {
+            return Unexpected(exp.error());
+        }
+        return out;
+    }
+
+    /** @copydoc render_to(OutputRef&, HandlebarsTemplate const&, dom::Value const&, HandlebarsOptions const&) const
+     */
+    Expected<void, HandlebarsError>
+    try_render_to(
+        OutputRef& out,
+        HandlebarsTemplate const& compiled,
+        dom::Value const& context,
+        HandlebarsOptions const& options) const;
+
     /** Register a partial
 
         This function registers a partial with the handlebars environment.
@@ -863,6 +1157,9 @@ public:
         </ul>
         @endcode
 
+        The partial is compiled when it is registered, so it is
+        not tokenized again every time it is rendered.
+
         @param name The name of the partial
         @param text The content of the partial
 
@@ -872,6 +1169,19 @@ public:
     void
     registerPartial(std::string_view name, std::string_view text);
 
+    /** Register a compiled partial
+
+        This function registers a partial that has already been
+        compiled. The compiled template is shared rather than
+        copied, so the same partials can be registered in many
+        environments without compiling them again.
+
+        @param name The name of the partial
+        @param compiled The compiled partial
+     */
+    void
+    registerPartial(std::string_view name, HandlebarsTemplate compiled);
+
     /** Unregister a partial
 
         This function unregisters a partial with the handlebars environment.
@@ -928,6 +1238,15 @@ public:
     void
     unregisterHelper(std::string_view name);
 
+    /** Determine if a helper is registered
+
+        @param name The name of the helper
+        @return `true` if a helper with this name
+        is registered in the environment
+     */
+    bool
+    hasHelper(std::string_view name) const;
+
     /** Register a logger
 
         This function registers a logger with the handlebars environment.
@@ -945,6 +1264,19 @@ public:
     void
     registerLogger(dom::Function fn);
 
+    /** Set the cache of rendered partials
+
+        The cache memoizes the output of the registered
+        partials it returns a key for.
+
+        @param cache The fragment cache, or a null
+        pointer to render all partials.
+
+        @see HandlebarsFragmentCache
+     */
+    void
+    setFragmentCache(std::shared_ptr<HandlebarsFragmentCache> cache);
+
     struct Tag;
 
 private:
@@ -1027,7 +1359,13 @@ private:
     std::pair<dom::Function, bool>
     getHelper(std::string_view name, bool isBlock) const;
 
-    std::pair<std::string_view, bool>
+    struct getPartialResult {
+        std::string_view text;
+        detail::CompiledTemplate const* compiled = nullptr;
+        bool found = false;
+    };
+
+    getPartialResult
     getPartial(
         std::string_view name,
         detail::RenderState const& state) const;
@@ -0,0 +1,197 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#ifndef MRDOCS_API_SUPPORT_HELPERPLUGIN_HPP
+#define MRDOCS_API_SUPPORT_HELPERPLUGIN_HPP
+
+/*  C interface for native Handlebars helpers
+
+    Addons can provide helpers as a shared library in
+    the `helpers` directory of a generator, next to the
+    JavaScript helpers. The library is loaded once per
+    generator and its helpers are called directly,
+    without the cost of the JavaScript interpreter.
+
+    This header only uses C, so plugins do not depend
+    on the C++ ABI or on the MrDocs headers. Values are
+    opaque handles that plugins access through the
+    functions in @ref mrdocs_helper_api.
+
+    A plugin exports a function named
+    `mrdocs_register_helpers` with the type
+    @ref mrdocs_register_helpers_fn:
+
+    @code
+    static int
+    add(
+        mrdocs_helper_api const* api,
+        mrdocs_value const* const* args,
+        size_t nargs,
+        mrdocs_value* result)
+    {
+        api->set_integer(result,
+            api->get_integer(args[0]) + api->get_integer(args[1]));
+        return 0;
+    }
+
+    MRDOCS_HELPER_PLUGIN_EXPORT
+    int
+    mrdocs_register_helpers(
+        unsigned version,
+        void* registry,
+        mrdocs_register_helper_fn register_helper)
+    {
+        if (version != MRDOCS_HELPER_PLUGIN_VERSION)
+            return 1;
+        register_helper(registry, "add", &add);
+        return 0;
+    }
+    @endcode
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MRDOCS_HELPER_PLUGIN_VERSION 1u
+
+#define MRDOCS_HELPER_PLUGIN_ENTRY "mrdocs_register_helpers"
+
+#if defined(_WIN32) && defined(__cplusplus)
+#  define MRDOCS_HELPER_PLUGIN_EXPORT extern "C" __declspec(dllexport)
+#elif defined(_WIN32)
+#  define MRDOCS_HELPER_PLUGIN_EXPORT __declspec(dllexport)
+#elif defined(__cplusplus)
+#  define MRDOCS_HELPER_PLUGIN_EXPORT extern "C" __attribute__((visibility("default")))
+#else
+#  define MRDOCS_HELPER_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** An opaque handle to a DOM value
+ */
+typedef struct mrdocs_value mrdocs_value;
+
+/** The kind of a DOM value
+ */
+typedef enum mrdocs_value_kind
+{
+    MRDOCS_VALUE_UNDEFINED = 0,
+    MRDOCS_VALUE_NULL,
+    MRDOCS_VALUE_BOOLEAN,
+    MRDOCS_VALUE_INTEGER,
+    MRDOCS_VALUE_STRING,
+    MRDOCS_VALUE_SAFE_STRING,
+    MRDOCS_VALUE_ARRAY,
+    MRDOCS_VALUE_OBJECT,
+    MRDOCS_VALUE_FUNCTION
+} mrdocs_value_kind;
+
+/** Functions to access DOM values
+
+    Strings returned by `get_string` remain valid
+    while the value they were obtained from is
+    not modified or destroyed.
+ */
+typedef struct mrdocs_helper_api
+{
+    /// The version of the interface
+    unsigned version;
+
+    /// Return the kind of a value
+    mrdocs_value_kind (*kind)(mrdocs_value const* v);
+
+    /// Return whether a value is truthy
+    int (*is_truthy)(mrdocs_value const* v);
+
+    /// Return the integer in a value, or zero
+    int64_t (*get_integer)(mrdocs_value const* v);
+
+    /// Return the string in a value and its size
+    char const* (*get_string)(mrdocs_value const* v, size_t* size);
+
+    /// Return the number of elements or properties
+    size_t (*size)(mrdocs_value const* v);
+
+    /// Store the property of an object in `out`
+    void (*get_property)(
+        mrdocs_value const* v,
+        char const* key,
+        size_t key_size,
+        mrdocs_value* out);
+
+    /// Store the element of an array in `out`
+    void (*get_element)(
+        mrdocs_value const* v,
+        size_t i,
+        mrdocs_value* out);
+
+    /// Create an undefined value
+    mrdocs_value* (*create)(void);
+
+    /// Destroy a value created with `create`
+    void (*destroy)(mrdocs_value* v);
+
+    /// Copy a value to `dst`
+    void (*copy)(mrdocs_value* dst, mrdocs_value const* src);
+
+    /// Set a value to null
+    void (*set_null)(mrdocs_value* v);
+
+    /// Set a value to a boolean
+    void (*set_boolean)(mrdocs_value* v, int b);
+
+    /// Set a value to an integer
+    void (*set_integer)(mrdocs_value* v, int64_t i);
+
+    /// Set a value to a string
+    void (*set_string)(mrdocs_value* v, char const* s, size_t size);
+
+    /// Set a value to a string that is not escaped
+    void (*set_safe_string)(mrdocs_value* v, char const* s, size_t size);
+} mrdocs_helper_api;
+
+/** A native helper
+
+    The arguments include the options object
+    as the last argument, as for all helpers.
+
+    @return Zero on success. Otherwise, `result`
+    should contain a string describing the error.
+ */
+typedef int (*mrdocs_helper_fn)(
+    mrdocs_helper_api const* api,
+    mrdocs_value const* const* args,
+    size_t nargs,
+    mrdocs_value* result);
+
+/** Register a native helper with a name
+ */
+typedef void (*mrdocs_register_helper_fn)(
+    void* registry,
+    char const* name,
+    mrdocs_helper_fn fn);
+
+/** The function exported by plugins
+
+    @return Zero on success.
+ */
+typedef int (*mrdocs_register_helpers_fn)(
+    unsigned version,
+    void* registry,
+    mrdocs_register_helper_fn register_helper);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // MRDOCS_API_SUPPORT_HELPERPLUGIN_HPP
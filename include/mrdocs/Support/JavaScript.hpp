@@ -345,6 +345,11 @@ public:
         If the function code contains more than one function, the
         return value is the first function compiled.
 
+        The bytecode of compiled functions is cached by
+        source code and shared by all contexts, so
+        compiling the same code again only loads the
+        bytecode.
+
         @param jsCode The JavaScript code to compile.
         @return A function object that can be called.
         The function object has the number of arguments
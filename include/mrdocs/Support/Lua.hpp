@@ -22,6 +22,9 @@
 
 
 namespace mrdocs {
+
+class Handlebars;
+
 namespace lua {
 
 struct Access;
@@ -493,6 +496,40 @@ public:
         Param value) const;
 };
 
+//------------------------------------------------
+
+/** Register a Lua helper function
+
+    This function registers a Lua function
+    as a helper function that can be called from
+    Handlebars templates.
+
+    The script is a Lua chunk that returns the
+    helper function:
+
+    @code
+    return function(a, b)
+        return a + b
+    end
+    @endcode
+
+    Objects, arrays, and functions are passed to
+    the helper as userdata that refer to the
+    original values, so they are not copied.
+
+    @param hbs The Handlebars instance to register the helper into
+    @param name The name of the helper function
+    @param ctx The Lua context to use
+    @param script The Lua chunk that returns the helper function
+ */
+MRDOCS_DECL
+Expected<void, Error>
+registerHelper(
+    mrdocs::Handlebars& hbs,
+    std::string_view name,
+    Context const& ctx,
+    std::string_view script);
+
 } // lua
 } // mrdocs
 
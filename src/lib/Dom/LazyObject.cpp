@@ -0,0 +1,82 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include <mrdocs/Dom/LazyObject.hpp>
+
+
+namespace mrdocs {
+namespace dom {
+namespace detail {
+
+LazyObjectKeys::
+LazyObjectKeys()
+{
+    tables_.push_back(std::make_unique<Table>());
+    table_.store(tables_.back().get(), std::memory_order_release);
+}
+
+LazyObjectKeys::
+~LazyObjectKeys() = default;
+
+std::uint32_t
+LazyObjectKeys::
+find(std::string_view key) const
+{
+    Table const& table = *table_.load(std::memory_order_acquire);
+    auto const it = table.slots.find(key);
+    if (it == table.slots.end())
+    {
+        return npos;
+    }
+    return it->second;
+}
+
+std::uint32_t
+LazyObjectKeys::
+insert(std::string_view key)
+{
+    if (std::uint32_t const slot = find(key); slot != npos)
+    {
+        return slot;
+    }
+
+    std::lock_guard lock(mutex_);
+    Table const& current = *table_.load(std::memory_order_relaxed);
+    if (auto const it = current.slots.find(key);
+        it != current.slots.end())
+    {
+        return it->second;
+    }
+
+    // Readers might still use the current table,
+    // so the new key goes into a copy of it
+    std::string_view const stored = storage_.emplace_back(key);
+    auto next = std::make_unique<Table>(current);
+    auto const slot = static_cast<std::uint32_t>(next->names.size());
+    next->slots.emplace(stored, slot);
+    next->names.push_back(stored);
+    table_.store(next.get(), std::memory_order_release);
+    tables_.push_back(std::move(next));
+    return slot;
+}
+
+std::string_view
+LazyObjectKeys::
+name(std::uint32_t const slot) const
+{
+    // Tables only grow, so the latest table
+    // has every slot of the previous ones
+    Table const& table = *table_.load(std::memory_order_acquire);
+    return table.names[slot];
+}
+
+} // detail
+} // dom
+} // mrdocs
@@ -10,8 +10,8 @@
 //
 
 #include "AdocEscape.hpp"
+#include <lib/Support/CharSet.hpp>
 #include <mrdocs/Support/Handlebars.hpp>
-#include <ranges>
 
 namespace mrdocs::adoc {
 
@@ -66,10 +66,26 @@ HTMLNamedEntity(char const c)
 void
 AdocEscape(OutputRef& os, std::string_view str)
 {
-    static constexpr char reserved[] = R"(~^_*`#[]{}<>\|-=&;+:."\'/)";
-    for (char c: str)
+    static constexpr std::string_view reserved = R"(~^_*`#[]{}<>\|-=&;+:."\'/)";
+    // Newlines are written on their own, as when each
+    // character was written separately, so indentation
+    // is applied to the output in the same way.
+    static constexpr CharSet stopChars("~^_*`#[]{}<>\\|-=&;+:.\"'/\n");
+    while (!str.empty())
     {
-        if (std::ranges::find(reserved, c) != std::end(reserved))
+        // Write the characters before the next
+        // reserved character at once
+        std::size_t const n = findFirstOf(str, stopChars);
+        if (n != 0)
+        {
+            os << str.substr(0, n);
+        }
+        if (n == str.size())
+        {
+            break;
+        }
+        char const c = str[n];
+        if (reserved.contains(c))
         {
             // https://docs.asciidoctor.org/asciidoc/latest/subs/replacements/
             if (auto e = HTMLNamedEntity(c))
@@ -85,6 +101,7 @@ AdocEscape(OutputRef& os, std::string_view str)
         {
             os << c;
         }
+        str.remove_prefix(n + 1);
     }
 }
 
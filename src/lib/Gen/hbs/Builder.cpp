@@ -14,8 +14,11 @@
 #include <mrdocs/Metadata/DomCorpus.hpp>
 #include <mrdocs/Support/Path.hpp>
 #include <mrdocs/Support/Report.hpp>
+#include <algorithm>
 #include <filesystem>
 #include <format>
+#include <memory>
+#include <vector>
 
 
 namespace mrdocs {
@@ -27,45 +30,120 @@ extern void lua_dump(dom::Object const& obj);
 namespace hbs {
 
 namespace {
-void
-loadPartials(
-    Handlebars& hbs,
-    std::string const& partialsPath)
+/* Split a URL into its '/'-separated segments
+
+   The URL must start with '/'. A trailing '/' adds
+   an empty segment, as in the elements of a
+   `std::filesystem::path`.
+
+   Returns false for URLs which the string-based
+   algorithm does not handle: those with empty,
+   "." or ".." segments, or with backslashes.
+ */
+bool
+splitURL(
+    std::string_view url,
+    std::vector<std::string_view>& segments)
 {
-    if (!files::exists(partialsPath))
+    segments.clear();
+    MRDOCS_CHECK_OR(url.starts_with('/'), false);
+    MRDOCS_CHECK_OR(url.find('\\') == std::string_view::npos, false);
+    url.remove_prefix(1);
+    MRDOCS_CHECK_OR(!url.empty(), true);
+    for (;;)
     {
-        return;
-    }
-    auto exp = forEachFile(partialsPath, true,
-        [&](std::string_view pathName) -> Expected<void>
+        std::size_t const slash = url.find('/');
+        std::string_view const segment = url.substr(0, slash);
+        MRDOCS_CHECK_OR(segment != "." && segment != "..", false);
+        if (slash == std::string_view::npos)
         {
-            // Skip directories
-            MRDOCS_CHECK_OR(!files::isDirectory(pathName), {});
-
-            // Get template relative path
-            std::filesystem::path relPath = pathName;
-            relPath = relPath.lexically_relative(partialsPath);
+            segments.push_back(segment);
+            return true;
+        }
+        MRDOCS_CHECK_OR(!segment.empty(), false);
+        segments.push_back(segment);
+        url.remove_prefix(slash + 1);
+    }
+}
 
-            // Skip non-handlebars files
-            MRDOCS_CHECK_OR(relPath.extension() == ".hbs", {});
+/* Segments of the URLs passed to relativize
 
-            // Remove any file extensions
-            while(relPath.has_extension())
+   Most links on a page are relative to the page
+   itself, so the directory of the last `from`
+   URL is kept split. Each builder has its own
+   cache because builders run on separate threads.
+ */
+class RelativizeCache
+{
+    std::string from_;
+    std::vector<std::string_view> fromDir_;
+    bool fromOk_ = false;
+    std::vector<std::string_view> to_;
+
+public:
+    /* Return the segments of the parent directory of `from`
+
+       This is null if `from` needs the general algorithm.
+     */
+    std::vector<std::string_view> const*
+    fromDir(std::string_view from)
+    {
+        if (from != from_)
+        {
+            from_ = from;
+            // The parent of "/" is empty, which is
+            // not an absolute path
+            fromOk_ = from_ != "/" && splitURL(from_, fromDir_);
+            if (fromOk_)
             {
-                relPath.replace_extension();
+                // Remove the file name, or the empty
+                // segment of a trailing '/'
+                fromDir_.pop_back();
             }
+        }
+        return fromOk_ ? &fromDir_ : nullptr;
+    }
 
-            // Load partial contents
-            MRDOCS_TRY(std::string text, files::getFileText(pathName));
+    /* Return the segments of `to`, or null
+     */
+    std::vector<std::string_view> const*
+    to(std::string_view to)
+    {
+        MRDOCS_CHECK_OR(splitURL(to, to_), nullptr);
+        return &to_;
+    }
+};
 
-            // Register partial
-            hbs.registerPartial(relPath.generic_string(), text);
-            return {};
-        });
-    if (!exp)
+/* Make a URL relative to a directory
+
+   This is equivalent to `std::filesystem::path::lexically_relative`
+   for absolute URLs split with @ref splitURL.
+ */
+std::string
+relativeURL(
+    std::vector<std::string_view> const& to,
+    std::vector<std::string_view> const& fromDir)
+{
+    auto const [toIt, fromIt] = std::ranges::mismatch(to, fromDir);
+    std::size_t const n = fromDir.end() - fromIt;
+    if (n == 0 && (toIt == to.end() || toIt->empty()))
     {
-        exp.error().Throw();
+        return ".";
     }
+    std::string result;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        result += i == 0 ? ".." : "/..";
+    }
+    for (auto it = toIt; it != to.end(); ++it)
+    {
+        if (!result.empty() && !result.ends_with('/'))
+        {
+            result += '/';
+        }
+        result += *it;
+    }
+    return result;
 }
 
 /* Make a URL relative to another URL.
@@ -82,7 +160,11 @@ loadPartials(
    @see https://gitlab.com/antora/antora-ui-default/-/blob/master/src/helpers/relativize.js
  */
 dom::Value
-relativize_fn(dom::Value to0, dom::Value from0, dom::Value options)
+relativize_fn(
+    RelativizeCache& cache,
+    dom::Value to0,
+    dom::Value from0,
+    dom::Value options)
 {
     if (!to0)
     {
@@ -140,8 +222,18 @@ relativize_fn(dom::Value to0, dom::Value from0, dom::Value options)
     }
 
     // Handle the general case
-    std::string const fromDir = files::getParentDir(from);
-    std::string relativePath = std::filesystem::path(to).lexically_relative(fromDir).generic_string();
+    std::string relativePath;
+    auto const* fromDir = cache.fromDir(from);
+    auto const* toSegments = fromDir ? cache.to(to) : nullptr;
+    if (toSegments)
+    {
+        relativePath = relativeURL(*toSegments, *fromDir);
+    }
+    else
+    {
+        std::string const fromDirPath = files::getParentDir(from);
+        relativePath = std::filesystem::path(to).lexically_relative(fromDirPath).generic_string();
+    }
     if (relativePath.empty())
     {
         relativePath = ".";
@@ -163,34 +255,20 @@ relativize_fn(dom::Value to0, dom::Value from0, dom::Value options)
 Builder::
 Builder(
     HandlebarsCorpus const& corpus,
+    std::shared_ptr<TemplateStore const> store,
     std::function<void(OutputRef&, std::string_view)> escapeFn)
-    : escapeFn_(std::move(escapeFn))
+    : store_(std::move(store))
+    , escapeFn_(std::move(escapeFn))
     , domCorpus(corpus)
 {
-    namespace fs = std::filesystem;
-
-    // load partials
-    loadPartials(hbs_, commonTemplatesDir("partials"));
-    loadPartials(hbs_, templatesDir("partials"));
+    MRDOCS_ASSERT(store_);
 
-    // Load JavaScript helpers
-    std::string helpersPath = templatesDir("helpers");
-    auto exp = forEachFile(helpersPath, true,
-        [&](std::string_view pathName)-> Expected<void>
-        {
-            // Register JS helper function in the global object
-            constexpr std::string_view ext = ".js";
-            if (!pathName.ends_with(ext)) return {};
-            auto name = files::getFileName(pathName);
-            name.remove_suffix(ext.size());
-            MRDOCS_TRY(auto script, files::getFileText(pathName));
-            MRDOCS_TRY(js::registerHelper(hbs_, name, ctx_, script));
-            return {};
-        });
-    if (!exp)
+    // Register shared partials
+    for (auto const& [name, partial] : store_->partials)
     {
-        exp.error().Throw();
+        hbs_.registerPartial(name, partial);
     }
+    hbs_.setFragmentCache(store_->fragments);
 
     hbs_.registerHelper("primary_location",
         dom::makeInvocable([](dom::Value const& v) ->
@@ -242,22 +320,58 @@ Builder(
     helpers::registerMathHelpers(hbs_);
     helpers::registerContainerHelpers(hbs_);
     helpers::registerTypeHelpers(hbs_);
-    hbs_.registerHelper("relativize", dom::makeInvocable(relativize_fn));
+    hbs_.registerHelper("relativize", dom::makeInvocable(
+        [cache = std::make_shared<RelativizeCache>()](
+            dom::Value to, dom::Value from, dom::Value options)
+        {
+            return relativize_fn(*cache, std::move(to), std::move(from), std::move(options));
+        }));
 
-    // Load layout templates
-    std::string indexTemplateFilename =
-        std::format("index.{}.hbs", domCorpus.fileExtension);
-    std::string wrapperTemplateFilename =
-        std::format("wrapper.{}.hbs", domCorpus.fileExtension);
-    for (std::string const& filename : {indexTemplateFilename, wrapperTemplateFilename})
+    // Addon helpers can replace the helpers of the
+    // handlebars environment, but not the generator
+    // helpers above. The helpers they would shadow
+    // are not registered at all.
+    static Handlebars const coreHelpers;
+    auto const isGeneratorHelper = [&](std::string_view name)
     {
-        std::string pathName = files::appendPath(layoutDir(), filename);
-        Expected<std::string> text = files::getFileText(pathName);
-        if (!text)
+        return hbs_.hasHelper(name) && !coreHelpers.hasHelper(name);
+    };
+
+    // Register native helpers
+    for (NativeHelper const& helper : store_->nativeHelpers)
+    {
+        if (!isGeneratorHelper(helper.name))
         {
-            text.error().Throw();
+            hbs_.registerHelper(helper.name, makeNativeHelper(helper));
+        }
+    }
+
+    // Register Lua helpers in the state of this builder
+    for (auto const& [name, script] : store_->luaHelperScripts)
+    {
+        if (isGeneratorHelper(name))
+        {
+            continue;
+        }
+        auto exp = lua::registerHelper(hbs_, name, luaCtx_, script);
+        if (!exp)
+        {
+            exp.error().Throw();
+        }
+    }
+
+    // Register JavaScript helpers in the context of this builder
+    for (auto const& [name, script] : store_->helperScripts)
+    {
+        if (isGeneratorHelper(name))
+        {
+            continue;
+        }
+        auto exp = js::registerHelper(hbs_, name, ctx_, script);
+        if (!exp)
+        {
+            exp.error().Throw();
         }
-        templates_.emplace(filename, text.value());
     }
 }
 
@@ -266,18 +380,16 @@ Builder(
 Expected<void>
 Builder::
 callTemplate(
-    std::ostream& os,
+    OutputRef out,
     std::string_view name,
     dom::Value const& context)
 {
-    auto it = templates_.find(name);
-    MRDOCS_CHECK(it != templates_.end(), formatError("Template {} not found", name));
-    std::string_view fileText = it->second;
+    auto it = store_->layouts.find(name);
+    MRDOCS_CHECK(it != store_->layouts.end(), formatError("Template {} not found", name));
     HandlebarsOptions options;
     options.escapeFunction = escapeFn_;
-    OutputRef out(os);
     Expected<void, HandlebarsError> exp =
-        hbs_.try_render_to(out, fileText, context, options);
+        hbs_.try_render_to(out, it->second, context, options);
     if (!exp)
     {
         return Unexpected(Error(exp.error().what()));
@@ -317,17 +429,20 @@ createContext(Symbol const& I)
 template <std::derived_from<Symbol> T>
 Expected<void>
 Builder::
-operator()(std::ostream& os, T const& I)
+operator()(OutputRef out, T const& I)
 {
   std::string const templateFile =
       std::format("index.{}.hbs", domCorpus.fileExtension);
   dom::Object const ctx = createContext(I);
+  OutputBuffer buf(out);
 
   if (auto &config = domCorpus->config;
       config->embedded || !config->multipage) {
     // Single page or embedded pages render the index template directly
     // without the wrapper
-    return callTemplate(os, templateFile, ctx);
+    MRDOCS_TRY(callTemplate(buf, templateFile, ctx));
+    buf.flush();
+    return {};
   }
 
     // Multipage output: render the wrapper template
@@ -336,18 +451,20 @@ operator()(std::ostream& os, T const& I)
     auto const wrapperFile =
         std::format("wrapper.{}.hbs", domCorpus.fileExtension);
     dom::Object const wrapperCtx = createFrame(ctx);
-    wrapperCtx.set("contents", dom::makeInvocable([this, &I, templateFile, &os](
+    wrapperCtx.set("contents", dom::makeInvocable([this, &I, templateFile, &buf](
         dom::Value const&) -> Expected<dom::Value>
         {
-            // Helper to write contents directly to stream
-            MRDOCS_TRY(callTemplate(os, templateFile, createContext(I)));
+            // Helper to write contents directly to the page buffer
+            MRDOCS_TRY(callTemplate(buf, templateFile, createContext(I)));
             return {};
         }));
-    return callTemplate(os, wrapperFile, wrapperCtx);
+    MRDOCS_TRY(callTemplate(buf, wrapperFile, wrapperCtx));
+    buf.flush();
+    return {};
 }
 
 // Compile the Builder::operator() for each Symbol type
-#define INFO(T) template Expected<void> Builder::operator()<T##Symbol>(std::ostream&, T##Symbol const&);
+#define INFO(T) template Expected<void> Builder::operator()<T##Symbol>(OutputRef, T##Symbol const&);
 #include <mrdocs/Metadata/Symbol/SymbolNodes.inc>
 
 Expected<void>
@@ -358,80 +475,25 @@ renderWrapped(
 {
   auto const wrapperFile =
       std::format("wrapper.{}.hbs", domCorpus.fileExtension);
+  OutputBuffer buf(os);
   dom::Object ctx;
   ctx.set("contents",
           dom::makeInvocable([&](dom::Value const &) -> Expected<dom::Value> {
+            // The contents are written directly to ostream
+            buf.flush();
             MRDOCS_TRY(contentsCb());
             return {};
           }));
 
-  // Render the wrapper directly to ostream
-  auto pathName = files::appendPath(layoutDir(), wrapperFile);
-  MRDOCS_TRY(auto fileText, files::getFileText(pathName));
-  HandlebarsOptions options;
-  options.escapeFunction = escapeFn_;
-  OutputRef outRef(os);
-  Expected<void, HandlebarsError> exp =
-      hbs_.try_render_to(outRef, fileText, ctx, options);
+  // Render the wrapper to ostream
+  Expected<void> exp = callTemplate(buf, wrapperFile, ctx);
   if (!exp) {
-    Error(exp.error().what()).Throw();
+    exp.error().Throw();
   }
+  buf.flush();
     return {};
 }
 
-std::string
-Builder::
-layoutDir() const
-{
-    return templatesDir("layouts");
-}
-
-std::string
-Builder::
-templatesDir() const
-{
-    Config const& config = domCorpus->config;
-    return files::appendPath(
-        config->addons,
-        "generator",
-        domCorpus.fileExtension);
-}
-
-std::string
-Builder::
-templatesDir(std::string_view subdir) const
-{
-    Config const& config = domCorpus->config;
-    return files::appendPath(
-        config->addons,
-        "generator",
-        domCorpus.fileExtension,
-        subdir);
-}
-
-std::string
-Builder::
-commonTemplatesDir() const
-{
-    Config const& config = domCorpus->config;
-    return files::appendPath(
-        config->addons,
-        "generator",
-        "common");
-}
-
-std::string
-Builder::
-commonTemplatesDir(std::string_view const subdir) const
-{
-    Config const& config = domCorpus->config;
-    return files::appendPath(
-        config->addons,
-        "generator",
-        "common",
-        subdir);
-}
-
 
 } // hbs
 } // mrdocs
@@ -13,11 +13,13 @@
 #define MRDOCS_LIB_GEN_HBS_BUILDER_HPP
 
 #include <lib/Gen/hbs/HandlebarsCorpus.hpp>
+#include <lib/Gen/hbs/TemplateStore.hpp>
 #include <lib/Support/Radix.hpp>
 #include <mrdocs/Metadata/DomCorpus.hpp>
 #include <mrdocs/Support/Error.hpp>
 #include <mrdocs/Support/Handlebars.hpp>
 #include <mrdocs/Support/JavaScript.hpp>
+#include <mrdocs/Support/Lua.hpp>
 #include <ostream>
 
 
@@ -32,8 +34,9 @@ namespace hbs {
 class Builder
 {
     js::Context ctx_;
+    lua::Context luaCtx_;
     Handlebars hbs_;
-    std::map<std::string, std::string, std::less<>> templates_;
+    std::shared_ptr<TemplateStore const> store_;
     std::function<void(OutputRef&, std::string_view)> escapeFn_;
 
     std::string
@@ -42,9 +45,14 @@ class Builder
 public:
     HandlebarsCorpus const& domCorpus;
 
-    explicit
+    /** Constructor.
+
+        The builder registers the partials and helpers
+        from the store, which is shared by all builders.
+     */
     Builder(
         HandlebarsCorpus const& corpus,
+        std::shared_ptr<TemplateStore const> store,
         std::function<void(OutputRef&, std::string_view)> escapeFn);
 
     /** Render the contents for a symbol.
@@ -59,7 +67,7 @@ public:
      */
     template<std::derived_from<Symbol> T>
     Expected<void>
-    operator()(std::ostream& os, T const&);
+    operator()(OutputRef out, T const&);
 
     /** Render the contents in the wrapper layout.
 
@@ -78,31 +86,6 @@ public:
         std::function<Expected<void>()> contentsCb);
 
 private:
-    /** The directory with the all templates.
-     */
-    std::string
-    templatesDir() const;
-
-    /** A subdirectory of the templates dir
-     */
-    std::string
-    templatesDir(std::string_view subdir) const;
-
-    /** The directory with the common templates.
-     */
-    std::string
-    commonTemplatesDir() const;
-
-    /** A subdirectory of the common templates dir
-     */
-    std::string
-    commonTemplatesDir(std::string_view subdir) const;
-
-    /** The directory with the layout templates.
-     */
-    std::string
-    layoutDir() const;
-
     /** Create a handlebars context with the symbol and helper information.
 
         The helper information includes all information from the
@@ -118,7 +101,7 @@ private:
      */
     Expected<void>
     callTemplate(
-        std::ostream& os,
+        OutputRef out,
         std::string_view name,
         dom::Value const& context);
 
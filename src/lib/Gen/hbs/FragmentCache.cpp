@@ -0,0 +1,109 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include "FragmentCache.hpp"
+#include <mrdocs/Support/Error.hpp>
+#include <format>
+
+namespace mrdocs::hbs {
+
+FragmentCache::
+FragmentCache(
+    std::map<std::string, std::vector<std::string>, std::less<>> keys,
+    std::size_t const capacity)
+    : keys_(std::move(keys))
+    , maxShardBytes_(capacity / shardCount)
+{
+}
+
+FragmentCache::Shard&
+FragmentCache::
+shardOf(std::string_view key)
+{
+    return shards_[std::hash<std::string_view>{}(key) % shardCount];
+}
+
+std::string
+FragmentCache::
+key(
+    std::string_view partialName,
+    dom::Value const& context,
+    dom::Value const& root)
+{
+    auto it = keys_.find(partialName);
+    MRDOCS_CHECK_OR(it != keys_.end(), {});
+
+    std::string result(partialName);
+    for (std::string_view path : it->second)
+    {
+        dom::Value const v = path.starts_with("@root.") ?
+            root.lookup(path.substr(6)) :
+            context.lookup(path);
+        result.push_back('\0');
+        switch (v.kind())
+        {
+        case dom::Kind::Null:
+            result.push_back('n');
+            break;
+        case dom::Kind::Boolean:
+            result.push_back(v.getBool() ? 't' : 'f');
+            break;
+        case dom::Kind::Integer:
+            result += std::format("i{}", v.getInteger());
+            break;
+        case dom::Kind::String:
+        case dom::Kind::SafeString:
+            result.push_back('s');
+            result += v.getString().get();
+            break;
+        default:
+            // Missing values, objects, arrays, and
+            // functions can't identify the output
+            return {};
+        }
+    }
+    return result;
+}
+
+std::optional<std::string>
+FragmentCache::
+find(std::string_view key)
+{
+    Shard& shard = shardOf(key);
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.index.find(key);
+    MRDOCS_CHECK_OR(it != shard.index.end(), std::nullopt);
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return it->second->second;
+}
+
+void
+FragmentCache::
+insert(std::string key, std::string fragment)
+{
+    std::size_t const bytes = key.size() + fragment.size();
+    MRDOCS_CHECK_OR_VOID(bytes <= maxShardBytes_);
+
+    Shard& shard = shardOf(key);
+    std::lock_guard lock(shard.mutex);
+    MRDOCS_CHECK_OR_VOID(!shard.index.contains(key));
+    shard.lru.emplace_front(std::move(key), std::move(fragment));
+    shard.index.emplace(shard.lru.front().first, shard.lru.begin());
+    shard.bytes += bytes;
+    while (shard.bytes > maxShardBytes_)
+    {
+        auto& [oldKey, oldFragment] = shard.lru.back();
+        shard.bytes -= oldKey.size() + oldFragment.size();
+        shard.index.erase(oldKey);
+        shard.lru.pop_back();
+    }
+}
+
+} // mrdocs::hbs
@@ -0,0 +1,104 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#ifndef MRDOCS_LIB_GEN_HBS_FRAGMENTCACHE_HPP
+#define MRDOCS_LIB_GEN_HBS_FRAGMENTCACHE_HPP
+
+#include <mrdocs/Dom.hpp>
+#include <mrdocs/Support/Handlebars.hpp>
+#include <array>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mrdocs::hbs {
+
+/** Rendered partials shared by all builders of a generator
+
+    Template authors mark a partial as cacheable by
+    listing the values its output depends on in a
+    `Cache Key:` line of the partial's leading comment:
+
+    @code
+    {{!--
+        Expected Context: {Symbol Object}
+        Cache Key: id, @root.symbol.url
+    --}}
+    @endcode
+
+    Keys are looked up in the partial context, or in
+    the root context when they start with `@root.`.
+    The partial is rendered once for each combination
+    of these values. Only null, boolean, integer, and
+    string values can identify the output: a partial
+    is always rendered when any of its key values is
+    an object, an array, or a function.
+
+    Fragments are stored in shards, each with its own
+    lock, and the least recently used fragments of a
+    shard are evicted when the shard exceeds its share
+    of the capacity.
+*/
+class FragmentCache final
+    : public HandlebarsFragmentCache
+{
+    static constexpr std::size_t shardCount = 16;
+
+    struct Shard
+    {
+        std::mutex mutex;
+        // Most recently used first
+        std::list<std::pair<std::string, std::string>> lru;
+        std::unordered_map<
+            std::string_view,
+            std::list<std::pair<std::string, std::string>>::iterator> index;
+        std::size_t bytes = 0;
+    };
+
+    std::map<std::string, std::vector<std::string>, std::less<>> keys_;
+    std::size_t const maxShardBytes_;
+    std::array<Shard, shardCount> shards_;
+
+    Shard&
+    shardOf(std::string_view key);
+
+public:
+    /** Constructor
+
+        @param keys The key paths of each cacheable partial
+        @param capacity The maximum number of bytes
+        of the keys and fragments in the cache.
+     */
+    explicit
+    FragmentCache(
+        std::map<std::string, std::vector<std::string>, std::less<>> keys,
+        std::size_t capacity = 64 * 1024 * 1024);
+
+    std::string
+    key(
+        std::string_view partialName,
+        dom::Value const& context,
+        dom::Value const& root) override;
+
+    std::optional<std::string>
+    find(std::string_view key) override;
+
+    void
+    insert(std::string key, std::string fragment) override;
+};
+
+} // mrdocs::hbs
+
+#endif // MRDOCS_LIB_GEN_HBS_FRAGMENTCACHE_HPP
@@ -49,8 +49,11 @@ getURL(Symbol const& I) const
     bool const multipage = getCorpus().config->multipage;
     char const prefix = multipage ? '/' : '#';
     char const delim = multipage ? '/' : '-';
-    std::string href(1, prefix);
-    href += names_.getQualified(I.id, delim);
+    std::string_view const name = names_.getQualified(I.id, delim);
+    std::string href;
+    href.reserve(1 + name.size() + (multipage ? 1 + fileExtension.size() : 0));
+    href.push_back(prefix);
+    href.append(name);
     if (multipage)
     {
         href.append(".");
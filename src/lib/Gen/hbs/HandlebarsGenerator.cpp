@@ -14,15 +14,21 @@
 #include "Builder.hpp"
 #include "HandlebarsCorpus.hpp"
 #include "MultiPageVisitor.hpp"
+#include "PageManifest.hpp"
+#include "PageWriter.hpp"
 #include "SinglePageVisitor.hpp"
 #include "TagfileWriter.hpp"
+#include "TemplateStore.hpp"
+#include <lib/Support/Chrono.hpp>
 #include <lib/Support/RawOstream.hpp>
 #include <mrdocs/Support/Path.hpp>
 #include <mrdocs/Support/Report.hpp>
 #include <llvm/ADT/SmallString.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Path.h>
+#include <algorithm>
 #include <fstream>
+#include <optional>
 #include <sstream>
 
 namespace mrdocs::hbs {
@@ -36,11 +42,35 @@ createEscapeFn(HandlebarsGenerator const& gen)
     };
 }
 
+/* Load the templates shared by all builders
+
+   The templates are loaded once and referenced
+   by the builders of every thread.
+ */
+Expected<std::shared_ptr<TemplateStore const>>
+createTemplateStore(HandlebarsCorpus const& hbsCorpus)
+{
+    using clock_type = std::chrono::steady_clock;
+    auto const start_time = clock_type::now();
+    MRDOCS_TRY(auto store, TemplateStore::create(hbsCorpus));
+    report::info(
+        "Loaded {} partials and {} helpers in {}",
+        store->partials.size(),
+        store->nativeHelpers.size() +
+            store->luaHelperScripts.size() +
+            store->helperScripts.size(),
+        format_duration(clock_type::now() - start_time));
+    return store;
+}
+
 Expected<ExecutorGroup<Builder>>
 createExecutors(
     HandlebarsGenerator const& gen,
-    HandlebarsCorpus const& hbsCorpus)
+    HandlebarsCorpus const& hbsCorpus,
+    std::shared_ptr<TemplateStore const> const& store)
 {
+    using clock_type = std::chrono::steady_clock;
+    auto const start_time = clock_type::now();
     auto const& config = hbsCorpus->config;
     auto& threadPool = config.threadPool();
     ExecutorGroup<Builder> group(threadPool);
@@ -48,16 +78,69 @@ createExecutors(
     {
         try
         {
-           group.emplace(hbsCorpus, createEscapeFn(gen));
+           group.emplace(hbsCorpus, store, createEscapeFn(gen));
         }
         catch(Exception const& ex)
         {
             return Unexpected(ex.error());
         }
     }
+    report::debug(
+        "Created {} builders in {}",
+        threadPool.getThreadCount(),
+        format_duration(clock_type::now() - start_time));
     return group;
 }
 
+/* The number of threads writing pages
+
+   Writing pages is I/O bound, so a few threads
+   are enough to keep the builders from waiting
+   on the filesystem.
+ */
+unsigned
+pageWriterConcurrency(Config const& config)
+{
+    unsigned const n = config.threadPool().getThreadCount();
+    MRDOCS_CHECK_OR(n > 1, 1);
+    return std::min(n, 4u);
+}
+
+/* Write a file with the output of a function
+
+   The parent directory is created if needed.
+ */
+template <class F>
+Expected<void>
+writeFile(
+    std::string_view const fileName,
+    F&& write)
+{
+    std::string const dir = files::getParentDir(fileName);
+    MRDOCS_TRY(files::createDirectory(dir));
+    std::ofstream os;
+    try
+    {
+        os.open(std::string(fileName),
+            std::ios_base::binary |
+                std::ios_base::out |
+                std::ios_base::trunc // | std::ios_base::noreplace
+            );
+    }
+    catch(std::exception const& ex)
+    {
+        return Unexpected(formatError("std::ofstream threw \"{}\"", ex.what()));
+    }
+    try
+    {
+        return write(os);
+    }
+    catch(std::exception const& ex)
+    {
+        return Unexpected(formatError("buildOne threw \"{}\"", ex.what()));
+    }
+}
+
 HandlebarsCorpus
 createDomCorpus(
     HandlebarsGenerator const& gen,
@@ -90,20 +173,52 @@ build(
 
     // Create corpus and executors
     HandlebarsCorpus domCorpus = createDomCorpus(*this, corpus);
-    MRDOCS_TRY(ExecutorGroup<Builder> ex, createExecutors(*this, domCorpus));
+    MRDOCS_TRY(auto store, createTemplateStore(domCorpus));
+    MRDOCS_TRY(ExecutorGroup<Builder> ex, createExecutors(*this, domCorpus, store));
+
+    // Load the pages of the previous run
+    std::optional<PageManifest> manifest;
+    if (corpus.config->skipUnchanged)
+    {
+        manifest.emplace(std::string(outputPath));
+        MRDOCS_TRY(manifest->load());
+    }
 
     // Visit the corpus
-    MultiPageVisitor visitor(ex, outputPath, corpus);
+    PageWriter writer(
+        pageWriterConcurrency(corpus.config),
+        manifest ? &*manifest : nullptr);
+    // The tagfile entries are computed by the same tasks
+    TagfileEntries tagfile;
+    bool const hasTagfile = !corpus.config->tagfile.empty();
+    MultiPageVisitor visitor(
+        ex, writer, outputPath, corpus,
+        hasTagfile ? &tagfile : nullptr);
     visitor(corpus.globalNamespace());
 
-    // Wait for all executors to finish and check errors
+    // Wait for all executors and pending pages to finish and check errors
     auto errors = ex.wait();
+    auto writeErrors = writer.wait();
+    errors.insert(errors.end(), writeErrors.begin(), writeErrors.end());
     MRDOCS_CHECK_OR(errors.empty(), Unexpected(errors));
     report::info("Generated {} pages", visitor.count());
+    if (manifest)
+    {
+        MRDOCS_TRY(manifest->save());
+        report::info("Skipped {} unchanged pages", manifest->unchanged());
+    }
 
-    MRDOCS_CHECK_OR(!corpus.config->tagfile.empty(), {});
-    MRDOCS_TRY(buildTagfile(corpus.config->tagfile, corpus));
-    return {};
+    MRDOCS_CHECK_OR(hasTagfile, {});
+    return writeFile(corpus.config->tagfile,
+        [&](std::ostream& os) -> Expected<void>
+        {
+            RawOstream raw_os(os);
+            MRDOCS_TRY(auto tagFileWriter, TagfileWriter::create(
+                domCorpus,
+                raw_os));
+            tagFileWriter.build(tagfile);
+            return {};
+        });
 }
 
 Expected<void>
@@ -142,29 +257,10 @@ buildTagfile(
     std::string_view const fileName,
     Corpus const& corpus) const
 {
-    std::string const dir = files::getParentDir(fileName);
-    MRDOCS_TRY(files::createDirectory(dir));
-    std::ofstream os;
-    try
-    {
-        os.open(std::string(fileName),
-            std::ios_base::binary |
-                std::ios_base::out |
-                std::ios_base::trunc // | std::ios_base::noreplace
-            );
-    }
-    catch(std::exception const& ex)
-    {
-        return Unexpected(formatError("std::ofstream threw \"{}\"", ex.what()));
-    }
-    try
+    return writeFile(fileName, [&](std::ostream& os)
     {
         return buildTagfile(os, corpus);
-    }
-    catch(std::exception const& ex)
-    {
-        return Unexpected(formatError("buildOne threw \"{}\"", ex.what()));
-    }
+    });
 }
 
 Expected<void>
@@ -175,7 +271,8 @@ buildOne(
 {
     // Create corpus and executors
     HandlebarsCorpus domCorpus = createDomCorpus(*this, corpus);
-    MRDOCS_TRY(ExecutorGroup<Builder> ex, createExecutors(*this, domCorpus));
+    MRDOCS_TRY(auto store, createTemplateStore(domCorpus));
+    MRDOCS_TRY(ExecutorGroup<Builder> ex, createExecutors(*this, domCorpus, store));
 
     // Embedded mode
     if (corpus.config->embedded)
@@ -192,7 +289,7 @@ buildOne(
     }
 
     // Wrapped mode
-    Builder inlineBuilder(domCorpus, createEscapeFn(*this));
+    Builder inlineBuilder(domCorpus, store, createEscapeFn(*this));
     return inlineBuilder.renderWrapped(os, [&]() -> Expected<void> {
         // This helper will write contents directly to ostream
         SinglePageVisitor visitor(ex, corpus, os);
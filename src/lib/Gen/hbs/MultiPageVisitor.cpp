@@ -13,7 +13,6 @@
 #include "VisitorHelpers.hpp"
 #include <mrdocs/Support/Path.hpp>
 #include <mrdocs/Support/Report.hpp>
-#include <fstream>
 
 namespace mrdocs::hbs {
 
@@ -27,41 +26,28 @@ operator()(T const& I)
         if (shouldGenerate(I, corpus_.config))
         {
             // ===================================
-            // Open the output file
+            // Render the page
             // ===================================
-            std::string const path = files::appendPath(outputPath_, builder.domCorpus.getURL(I));
-            std::string const dir = files::getParentDir(path);
-            if (auto exp = files::createDirectory(dir); !exp)
+            std::string page;
+            if (auto exp = builder(page, I); !exp)
             {
                 exp.error().Throw();
             }
-            std::ofstream os;
-            try
-            {
-                os.open(path,
-                        std::ios_base::binary |
-                            std::ios_base::out |
-                            std::ios_base::trunc // | std::ios_base::noreplace
-                );
-                if (!os.is_open()) {
-                    formatError(R"(std::ofstream("{}") failed)", path)
-                        .Throw();
-                }
-            }
-            catch (std::exception const& ex)
-            {
-                formatError(R"(std::ofstream("{}") threw "{}")", path, ex.what())
-                    .Throw();
-            }
 
             // ===================================
-            // Generate the output
+            // Hand the page to the writer
             // ===================================
-            if (auto exp = builder(os, I); !exp)
+            writer_.write(
+                files::appendPath(outputPath_, builder.domCorpus.getURL(I)),
+                std::move(page));
+
+            // ===================================
+            // Compute the tagfile entry
+            // ===================================
+            if (tagfile_)
             {
-                exp.error().Throw();
+                tagfile_->insert(builder.domCorpus, I);
             }
-
             count_.fetch_add(1, std::memory_order_relaxed);
         }
 
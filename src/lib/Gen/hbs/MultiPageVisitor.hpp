@@ -13,6 +13,8 @@
 #define MRDOCS_LIB_GEN_HBS_MULTIPAGEVISITOR_HPP
 
 #include <lib/Gen/hbs/Builder.hpp>
+#include <lib/Gen/hbs/PageWriter.hpp>
+#include <lib/Gen/hbs/TagfileWriter.hpp>
 #include <mrdocs/Metadata/Symbol.hpp>
 #include <mrdocs/Support/ExecutorGroup.hpp>
 #include <atomic>
@@ -28,18 +30,24 @@ namespace mrdocs::hbs {
 class MultiPageVisitor
 {
     ExecutorGroup<Builder>& ex_;
+    PageWriter& writer_;
     std::string_view outputPath_;
     Corpus const& corpus_;
+    TagfileEntries* tagfile_;
     std::atomic<std::size_t> count_ = 0;
 
 public:
     MultiPageVisitor(
         ExecutorGroup<Builder>& ex,
+        PageWriter& writer,
         std::string_view outputPath,
-        Corpus const& corpus) noexcept
+        Corpus const& corpus,
+        TagfileEntries* tagfile = nullptr) noexcept
         : ex_(ex)
+        , writer_(writer)
         , outputPath_(outputPath)
         , corpus_(corpus)
+        , tagfile_(tagfile)
     {
     }
 
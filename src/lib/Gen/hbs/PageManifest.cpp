@@ -0,0 +1,147 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include "PageManifest.hpp"
+#include <mrdocs/Support/Path.hpp>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SHA1.h>
+#include <fstream>
+#include <ranges>
+
+namespace mrdocs::hbs {
+
+namespace {
+std::string
+hashPage(std::string_view contents)
+{
+    return llvm::toHex(
+        llvm::SHA1::hash(llvm::arrayRefFromStringRef(contents)),
+        /*LowerCase=*/true);
+}
+
+/* Determine if a manifest entry is a path inside the directory
+
+   Stale pages are deleted, so entries of a damaged
+   or edited manifest must not refer to other files.
+ */
+bool
+isPagePath(std::string_view page)
+{
+    MRDOCS_CHECK_OR(!page.empty(), false);
+    MRDOCS_CHECK_OR(!page.starts_with('/') && !page.starts_with('\\'), false);
+    MRDOCS_CHECK_OR(page.find(':') == std::string_view::npos, false);
+    while (!page.empty())
+    {
+        std::size_t const sep = page.find_first_of("/\\");
+        MRDOCS_CHECK_OR(page.substr(0, sep) != "..", false);
+        if (sep == std::string_view::npos)
+        {
+            break;
+        }
+        page.remove_prefix(sep + 1);
+    }
+    return true;
+}
+} // (anon)
+
+PageManifest::
+PageManifest(std::string dir)
+    : dir_(std::move(dir))
+{
+}
+
+Expected<void>
+PageManifest::
+load()
+{
+    std::string const path = files::appendPath(dir_, fileName);
+    MRDOCS_CHECK_OR(files::exists(path), {});
+    MRDOCS_TRY(std::string text, files::getFileText(path));
+    std::string_view rest = text;
+    while (!rest.empty())
+    {
+        std::size_t const eol = rest.find('\n');
+        std::string_view line = rest.substr(0, eol);
+        rest = eol == std::string_view::npos ?
+            std::string_view() : rest.substr(eol + 1);
+        std::size_t const sep = line.find(' ');
+        if (sep == std::string_view::npos ||
+            !isPagePath(line.substr(sep + 1)))
+        {
+            continue;
+        }
+        previous_.insert_or_assign(
+            std::string(line.substr(sep + 1)),
+            std::string(line.substr(0, sep)));
+    }
+    return {};
+}
+
+bool
+PageManifest::
+update(std::string_view path, std::string_view contents)
+{
+    std::string_view rel = path;
+    if (rel.starts_with(dir_))
+    {
+        rel.remove_prefix(dir_.size());
+    }
+    while (rel.starts_with('/') || rel.starts_with('\\'))
+    {
+        rel.remove_prefix(1);
+    }
+    std::string key = files::makePosixStyle(rel);
+    std::string hash = hashPage(contents);
+
+    bool unchanged = false;
+    if (files::exists(path))
+    {
+        if (auto it = previous_.find(key); it != previous_.end())
+        {
+            unchanged = it->second == hash;
+        }
+        else if (auto text = files::getFileText(path))
+        {
+            unchanged = *text == contents;
+        }
+    }
+
+    std::lock_guard lock(mutex_);
+    current_.insert_or_assign(std::move(key), std::move(hash));
+    unchanged_ += unchanged;
+    return !unchanged;
+}
+
+Expected<void>
+PageManifest::
+save()
+{
+    for (auto const& page : previous_ | std::views::keys)
+    {
+        MRDOCS_CHECK_OR_CONTINUE(!current_.contains(page));
+        std::string const path = files::appendPath(dir_, page);
+        auto ec = llvm::sys::fs::remove(path);
+        MRDOCS_CHECK(!ec, formatError("fs::remove(\"{}\") returned \"{}\"", path, ec));
+    }
+
+    std::string const path = files::appendPath(dir_, fileName);
+    std::ofstream os(path, std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
+    MRDOCS_CHECK(os.is_open(), formatError(R"(std::ofstream("{}") failed)", path));
+    for (auto const& [page, hash] : current_)
+    {
+        os << hash << ' ' << page << '\n';
+    }
+    MRDOCS_CHECK(os.good(), formatError(R"(writing "{}" failed)", path));
+    previous_.clear();
+    return {};
+}
+
+} // mrdocs::hbs
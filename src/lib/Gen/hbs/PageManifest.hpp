@@ -0,0 +1,109 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#ifndef MRDOCS_LIB_GEN_HBS_PAGEMANIFEST_HPP
+#define MRDOCS_LIB_GEN_HBS_PAGEMANIFEST_HPP
+
+#include <mrdocs/Support/Error.hpp>
+#include <mrdocs/Support/Expected.hpp>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace mrdocs::hbs {
+
+/** The pages written to an output directory
+
+    The manifest records a hash of each page in
+    the output directory. When the pages are
+    generated again, pages with the same hash
+    as in the previous run are not rewritten,
+    so their modification times are preserved.
+
+    Pages listed in the previous manifest which
+    are not generated again are stale, and they
+    are deleted when the manifest is saved.
+    Files which are not listed in the manifest
+    are never deleted.
+
+    The manifest is stored in the output
+    directory as a text file with one line per
+    page, containing the hash and the path
+    relative to the directory.
+*/
+class PageManifest
+{
+    std::string dir_;
+    std::unordered_map<std::string, std::string> previous_;
+
+    std::mutex mutex_;
+    std::map<std::string, std::string> current_;
+    std::size_t unchanged_ = 0;
+
+public:
+    /** The name of the manifest file
+     */
+    static constexpr std::string_view fileName = ".mrdocs-manifest";
+
+    /** Constructor
+
+        @param dir The output directory
+     */
+    explicit
+    PageManifest(std::string dir);
+
+    /** Load the manifest of the previous run
+
+        A missing manifest is not an error.
+        Entries with an absolute path or with
+        `..` segments are ignored, so stale
+        pages are only deleted inside the
+        directory.
+     */
+    Expected<void>
+    load();
+
+    /** Record a page and check whether it must be written
+
+        The page is unchanged when the previous
+        manifest has the same hash for the page,
+        or when the page is not in the previous
+        manifest but the existing file has the
+        same contents.
+
+        This function can be called concurrently.
+
+        @param path The path of the page in the output directory
+        @param contents The contents of the page
+        @return `true` if the file should be written
+     */
+    bool
+    update(std::string_view path, std::string_view contents);
+
+    /** Delete stale pages and save the manifest
+     */
+    Expected<void>
+    save();
+
+    /** The number of pages which were not written
+     */
+    std::size_t
+    unchanged() const noexcept
+    {
+        return unchanged_;
+    }
+};
+
+} // mrdocs::hbs
+
+#endif // MRDOCS_LIB_GEN_HBS_PAGEMANIFEST_HPP
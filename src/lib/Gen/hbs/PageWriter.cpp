@@ -0,0 +1,115 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include "PageWriter.hpp"
+#include <mrdocs/Support/Path.hpp>
+#include <mrdocs/Support/ScopeExit.hpp>
+#include <fstream>
+
+namespace mrdocs::hbs {
+
+PageWriter::
+PageWriter(
+    unsigned concurrency,
+    PageManifest* manifest,
+    std::size_t maxPending)
+    : threadPool_(concurrency)
+    , tasks_(threadPool_)
+    , maxPending_(maxPending)
+    , manifest_(manifest)
+{
+}
+
+PageWriter::
+~PageWriter()
+{
+    // Errors are only reported by wait()
+    (void)tasks_.wait();
+}
+
+void
+PageWriter::
+write(std::string path, std::string contents)
+{
+    {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this] { return pending_ < maxPending_; });
+        ++pending_;
+    }
+    tasks_.async([this, path = std::move(path), contents = std::move(contents)]
+    {
+        ScopeExit done([this]
+        {
+            {
+                std::lock_guard lock(mutex_);
+                --pending_;
+            }
+            cv_.notify_one();
+        });
+        if (manifest_ && !manifest_->update(path, contents))
+        {
+            return;
+        }
+        writeFile(path, contents);
+    });
+}
+
+std::vector<Error>
+PageWriter::
+wait()
+{
+    return tasks_.wait();
+}
+
+void
+PageWriter::
+writeFile(std::string const& path, std::string const& contents)
+{
+    createDirectory(files::getParentDir(path));
+    std::ofstream os;
+    try
+    {
+        os.open(path,
+                std::ios_base::binary |
+                    std::ios_base::out |
+                    std::ios_base::trunc // | std::ios_base::noreplace
+        );
+        if (!os.is_open()) {
+            formatError(R"(std::ofstream("{}") failed)", path)
+                .Throw();
+        }
+        os.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+    catch (std::exception const& ex)
+    {
+        formatError(R"(std::ofstream("{}") threw "{}")", path, ex.what())
+            .Throw();
+    }
+}
+
+void
+PageWriter::
+createDirectory(std::string const& dir)
+{
+    {
+        std::lock_guard lock(dirsMutex_);
+        MRDOCS_CHECK_OR_VOID(!dirs_.contains(dir));
+    }
+    // Two threads might create the same directory,
+    // which is harmless
+    if (auto exp = files::createDirectory(dir); !exp)
+    {
+        exp.error().Throw();
+    }
+    std::lock_guard lock(dirsMutex_);
+    dirs_.insert(dir);
+}
+
+} // mrdocs::hbs
@@ -0,0 +1,109 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#ifndef MRDOCS_LIB_GEN_HBS_PAGEWRITER_HPP
+#define MRDOCS_LIB_GEN_HBS_PAGEWRITER_HPP
+
+#include <lib/Gen/hbs/PageManifest.hpp>
+#include <mrdocs/Support/Error.hpp>
+#include <mrdocs/Support/ThreadPool.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace mrdocs::hbs {
+
+/** Writes rendered pages to disk
+
+    Builders render each page into memory and hand
+    the buffer to the writer, which writes the files
+    on its own threads. Rendering threads never wait
+    on the filesystem unless the number of pending
+    pages reaches the limit of the writer.
+
+    Each output directory is created once, no matter
+    how many pages are written to it.
+
+    When the writer has a @ref PageManifest, pages
+    whose contents did not change since the previous
+    run are not written.
+*/
+class PageWriter
+{
+    ThreadPool threadPool_;
+    TaskGroup tasks_;
+    std::size_t const maxPending_;
+    PageManifest* manifest_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::size_t pending_ = 0;
+
+    std::mutex dirsMutex_;
+    std::unordered_set<std::string> dirs_;
+
+    void
+    writeFile(std::string const& path, std::string const& contents);
+
+    void
+    createDirectory(std::string const& dir);
+
+public:
+    /** Constructor
+
+        @param concurrency The number of threads writing
+        files. With one thread, files are written by
+        the caller of @ref write.
+        @param manifest The manifest of the output
+        directory, or null to write all pages.
+        @param maxPending The maximum number of pages
+        waiting to be written.
+     */
+    explicit
+    PageWriter(
+        unsigned concurrency,
+        PageManifest* manifest = nullptr,
+        std::size_t maxPending = 64);
+
+    /** Destructor
+
+        Pending pages are written before the
+        writer is destroyed.
+     */
+    ~PageWriter();
+
+    /** Write a page to a file
+
+        The parent directory is created if needed.
+        This function blocks while the number of
+        pending pages is at the limit.
+
+        @param path The path of the file
+        @param contents The contents of the page
+     */
+    void
+    write(std::string path, std::string contents);
+
+    /** Block until all pages are written
+
+        @return Zero or more errors from the
+        pages that could not be written.
+     */
+    [[nodiscard]]
+    std::vector<Error>
+    wait();
+};
+
+} // mrdocs::hbs
+
+#endif // MRDOCS_LIB_GEN_HBS_PAGEWRITER_HPP
@@ -12,7 +12,6 @@
 #include "SinglePageVisitor.hpp"
 #include "VisitorHelpers.hpp"
 #include <mrdocs/Support/unlock_guard.hpp>
-#include <sstream>
 
 namespace mrdocs::hbs {
 
@@ -23,19 +22,37 @@ operator()(T const& I)
 {
     if (shouldGenerate(I, corpus_.config))
     {
-        ex_.async([this, &I, symbolIdx = numSymbols_++](Builder& builder)
+        // Wait until the symbol fits in the window
+        // of pending symbols
+        std::size_t const symbolIdx = numSymbols_++;
         {
-            // Output to an independent string first (async), then write to
-            // the shared stream (sync)
-            std::stringstream ss;
-            if(auto r = builder(ss, I))
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&]
             {
-                writePage(ss.str(), symbolIdx);
+                return symbolIdx < topSymbol_ + symbols_.size();
+            });
+        }
+
+        ex_.async([this, &I, symbolIdx](Builder& builder)
+        {
+            // Render to an independent string first (async),
+            // then move it to the shared stream (sync)
+            std::string pageText;
+            try
+            {
+                if (auto r = builder(pageText, I); !r)
+                {
+                    r.error().Throw();
+                }
             }
-            else
+            catch (...)
             {
-                r.error().Throw();
+                // Release the slot so the symbols
+                // after this one are not blocked
+                writePage({}, symbolIdx);
+                throw;
             }
+            writePage(std::move(pageText), symbolIdx);
         });
     }
     MRDOCS_CHECK_OR_VOID(!I.isUsing());
@@ -46,7 +63,7 @@ operator()(T const& I)
 #define INFO(T) template void SinglePageVisitor::operator()<T##Symbol>(T##Symbol const&);
 #include <mrdocs/Metadata/Symbol/SymbolNodes.inc>
 
-// pageNumber is zero-based
+// symbolIdx is zero-based
 void
 SinglePageVisitor::
 writePage(
@@ -57,10 +74,9 @@ writePage(
 
     if (symbolIdx > topSymbol_)
     {
-        // Defer this symbol
-        if( symbols_.size() <= symbolIdx)
-            symbols_.resize(symbolIdx + 1);
-        symbols_[symbolIdx] = std::move(pageText);
+        // Defer this symbol. The window ensures
+        // no other pending symbol uses the slot.
+        symbols_[symbolIdx % symbols_.size()] = std::move(pageText);
         return;
     }
 
@@ -77,24 +93,21 @@ writePage(
         }
 
         topSymbol_ = symbolIdx;
-        if(symbolIdx >= symbols_.size())
-        {
-            // No deferred symbols to write
-            return;
-        }
+        cv_.notify_all();
 
-        if(! symbols_[symbolIdx])
+        Optional<std::string>& next = symbols_[symbolIdx % symbols_.size()];
+        if(! next)
         {
             // The next symbol is not set yet
             return;
         }
 
         // Render the next deferred symbol
-        pageText = std::move(*symbols_[symbolIdx]);
+        pageText = std::move(*next);
         // VFALCO this is in theory not needed, but
         // I am paranoid about the std::move of the
         // string not resulting in a deallocation.
-        symbols_[symbolIdx].reset();
+        next.reset();
     }
 }
 
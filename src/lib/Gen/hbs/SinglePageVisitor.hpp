@@ -14,6 +14,8 @@
 
 #include <lib/Gen/hbs/Builder.hpp>
 #include <mrdocs/Support/ExecutorGroup.hpp>
+#include <algorithm>
+#include <condition_variable>
 #include <mutex>
 #include <ostream>
 #include <string>
@@ -22,6 +24,14 @@
 namespace mrdocs::hbs {
 
 /** Visitor which writes everything to a single page.
+
+    Symbols are rendered concurrently and written
+    to the output in order. A symbol rendered before
+    the symbols that precede it waits in a window of
+    pending symbols. The visitor stops submitting new
+    symbols while the window is full, so the memory
+    used by pending symbols is bounded even when an
+    early symbol is slow to render.
 */
 class SinglePageVisitor
 {
@@ -30,7 +40,11 @@ class SinglePageVisitor
     std::ostream& os_;
     std::size_t numSymbols_ = 0;
     std::mutex mutex_;
+    std::condition_variable cv_;
     std::size_t topSymbol_ = 0;
+
+    // Pending symbols indexed by the symbol
+    // index modulo the size of the window
     std::vector<Optional<std::string>> symbols_;
 
     void writePage(std::string pageText, std::size_t symbolIdx);
@@ -38,10 +52,12 @@ public:
     SinglePageVisitor(
         ExecutorGroup<Builder>& ex,
         Corpus const& corpus,
-        std::ostream& os) noexcept
+        std::ostream& os,
+        std::size_t maxPending = 256)
         : ex_(ex)
         , corpus_(corpus)
         , os_(os)
+        , symbols_(std::max<std::size_t>(maxPending, 1))
     {
     }
 
@@ -16,6 +16,7 @@
 #include <lib/Support/RawOstream.hpp>
 #include <mrdocs/Support/Path.hpp>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
 
 namespace mrdocs {
 
@@ -56,6 +57,15 @@ build()
     finalize();
 }
 
+void
+TagfileWriter::
+build(TagfileEntries const& entries)
+{
+    initialize();
+    writeEntries(entries, corpus_->globalNamespace().id);
+    finalize();
+}
+
 void
 TagfileWriter::
 initialize()
@@ -85,12 +95,47 @@ operator()(T const& I)
         }
     }
 
+    writeCompound(I);
+
+    if constexpr (T::isNamespace())
+    {
+        // Write compound elements for the members of this namespace
+        corpus_->traverse(I, [this]<typename U>(U const& J)
+            {
+                this->operator()(J);
+            });
+    }
+}
+
+#define INFO(Type) template void TagfileWriter::operator()<Type##Symbol>(Type##Symbol const&);
+#include <mrdocs/Metadata/Symbol/SymbolNodes.inc>
+
+void
+TagfileWriter::
+writeEntries(
+    TagfileEntries const& entries,
+    SymbolID const& id)
+{
+    TagfileEntries::Entry const* entry = entries.find(id);
+    MRDOCS_CHECK_OR_VOID(entry);
+    os_ << entry->text;
+    for (SymbolID const& member : entry->members)
+    {
+        writeEntries(entries, member);
+    }
+}
+
+template<class T>
+void
+TagfileWriter::
+writeCompound(T const& I)
+{
     if constexpr (T::isNamespace())
     {
         // Namespaces are compound elements with members
         writeNamespace(I);
     }
-    else if (!T::isFunction())
+    else if constexpr (!T::isFunction())
     {
         // Functions are described as namespace members in the
         // scoped they belong to.
@@ -100,9 +145,6 @@ operator()(T const& I)
     }
 }
 
-#define INFO(Type) template void TagfileWriter::operator()<Type##Symbol>(Type##Symbol const&);
-#include <mrdocs/Metadata/Symbol/SymbolNodes.inc>
-
 void
 TagfileWriter::
 writeNamespace(
@@ -161,12 +203,6 @@ writeNamespace(
 
         tags_.close("compound");
     }
-
-    // Write compound elements for the members of this namespace
-    corpus_->traverse(I, [this]<typename U>(U const& J)
-        {
-            this->operator()(J);
-        });
 }
 
 template<class T>
@@ -283,4 +319,56 @@ generateFileAndAnchor(T const& I)
     return {url.substr(0, pos), url.substr(pos + 1)};
 }
 
+//------------------------------------------------
+//
+// TagfileEntries
+//
+//------------------------------------------------
+
+template<class T>
+void
+TagfileEntries::
+insert(
+    hbs::HandlebarsCorpus const& corpus,
+    T const& I)
+{
+    // Functions are written by their parent
+    if constexpr (!T::isFunction())
+    {
+        Entry entry;
+        if constexpr (T::isNamespace())
+        {
+            corpus->traverse(I, [&](Symbol const& J)
+            {
+                entry.members.push_back(J.id);
+            });
+        }
+        else
+        {
+            Symbol const* P = corpus->find(I.Parent);
+            MRDOCS_CHECK_OR_VOID(P && P->isNamespace());
+        }
+        {
+            llvm::raw_string_ostream os(entry.text);
+            TagfileWriter(corpus, os, {}).writeCompound(I);
+        }
+        Shard& shard = shards_[shardIndex(I.id)];
+        std::lock_guard lock(shard.mutex);
+        shard.entries.insert_or_assign(I.id, std::move(entry));
+    }
+}
+
+#define INFO(Type) template void TagfileEntries::insert<Type##Symbol>(hbs::HandlebarsCorpus const&, Type##Symbol const&);
+#include <mrdocs/Metadata/Symbol/SymbolNodes.inc>
+
+TagfileEntries::Entry const*
+TagfileEntries::
+find(SymbolID const& id) const noexcept
+{
+    auto const& entries = shards_[shardIndex(id)].entries;
+    auto it = entries.find(id);
+    MRDOCS_CHECK_OR(it != entries.end(), nullptr);
+    return &it->second;
+}
+
 } // mrdocs
\ No newline at end of file
@@ -16,8 +16,12 @@
 #include <lib/Gen/xml/XMLTags.hpp>
 #include <mrdocs/Metadata.hpp>
 #include <mrdocs/Support/Error.hpp>
+#include <array>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 
 namespace mrdocs {
@@ -26,6 +30,71 @@ struct SimpleWriterTag {}; //Tag dispatch for simple writers
 
 class jit_indenter;
 
+/** Tagfile entries computed while generating pages
+
+    The multipage generator computes the entry of
+    each symbol in the same task that renders the
+    page of the symbol, so the tagfile does not need
+    a second traversal of the corpus. The entries
+    are merged in document order by
+    @ref TagfileWriter::build.
+
+    Entries can be inserted concurrently. They are
+    spread over a few maps, each with its own mutex,
+    so the executors rarely contend for them.
+*/
+class TagfileEntries
+{
+public:
+    struct Entry
+    {
+        /// The compound elements of the symbol
+        std::string text;
+
+        /// The members of a namespace, in order
+        std::vector<SymbolID> members;
+    };
+
+    /** Compute and store the entry of a symbol.
+
+        Only symbols which are generated should be
+        inserted. Symbols other than namespaces are
+        ignored unless their parent is a namespace,
+        because the tagfile only describes namespace
+        members.
+
+        @param corpus The corpus of the generator
+        @param I The symbol
+     */
+    template<class T>
+    void
+    insert(hbs::HandlebarsCorpus const& corpus, T const& I);
+
+    /** Return the entry of a symbol, or null.
+
+        This function should only be called once
+        all entries are inserted.
+     */
+    Entry const*
+    find(SymbolID const& id) const noexcept;
+
+private:
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<SymbolID, Entry> entries;
+    };
+
+    std::array<Shard, 16> shards_;
+
+    static
+    std::size_t
+    shardIndex(SymbolID const& id) noexcept
+    {
+        return std::hash<SymbolID>()(id) % 16;
+    }
+};
+
 /** A writer which outputs Tagfiles.
 */
 class TagfileWriter
@@ -98,7 +167,18 @@ public:
     void
     build();
 
+    /** Build the tagfile from precomputed entries.
+
+        This function writes the entries in the
+        same order as @ref build, without
+        traversing the corpus.
+     */
+    void
+    build(TagfileEntries const& entries);
+
 private:
+    friend class TagfileEntries;
+
     // ==================================================
     // Build
     // ==================================================
@@ -112,9 +192,16 @@ private:
     void
     finalize();
 
+    void
+    writeEntries(TagfileEntries const& entries, SymbolID const& id);
+
     // ==================================================
     // Write
     // ==================================================
+    template<class T>
+    void
+    writeCompound(T const& I);
+
     void
     writeNamespace(NamespaceSymbol const&);
 
@@ -0,0 +1,238 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include "TemplateStore.hpp"
+#include <lib/ConfigImpl.hpp>
+#include <mrdocs/Support/Path.hpp>
+#include <mrdocs/Support/String.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <format>
+
+namespace mrdocs::hbs {
+
+namespace {
+/* The directory with the templates of the generator
+ */
+std::string
+templatesDir(
+    HandlebarsCorpus const& corpus,
+    std::string_view subdir)
+{
+    Config const& config = corpus->config;
+    return files::appendPath(
+        config->addons,
+        "generator",
+        corpus.fileExtension,
+        subdir);
+}
+
+/* The directory with the templates common to all generators
+ */
+std::string
+commonTemplatesDir(
+    HandlebarsCorpus const& corpus,
+    std::string_view subdir)
+{
+    Config const& config = corpus->config;
+    return files::appendPath(
+        config->addons,
+        "generator",
+        "common",
+        subdir);
+}
+
+/* The keys of a cacheable partial
+
+   The keys are listed in a "Cache Key:" line of
+   the comment at the beginning of the partial.
+ */
+std::vector<std::string>
+findCacheKeys(std::string_view text)
+{
+    text = ltrim(text);
+    MRDOCS_CHECK_OR(text.starts_with("{{!--"), {});
+    std::size_t const end = text.find("--}}");
+    MRDOCS_CHECK_OR(end != std::string_view::npos, {});
+    std::string_view comment = text.substr(0, end);
+    constexpr std::string_view label = "Cache Key:";
+    std::size_t const pos = comment.find(label);
+    MRDOCS_CHECK_OR(pos != std::string_view::npos, {});
+    std::string_view line = comment.substr(pos + label.size());
+    line = line.substr(0, line.find('\n'));
+
+    std::vector<std::string> keys;
+    while (!line.empty())
+    {
+        std::size_t const comma = line.find(',');
+        std::string_view key = trim(line.substr(0, comma));
+        if (!key.empty())
+        {
+            keys.emplace_back(key);
+        }
+        if (comma == std::string_view::npos)
+        {
+            break;
+        }
+        line.remove_prefix(comma + 1);
+    }
+    return keys;
+}
+
+Expected<void>
+loadPartials(
+    TemplateStore& store,
+    std::map<std::string, std::vector<std::string>, std::less<>>& cacheKeys,
+    std::string const& partialsPath)
+{
+    if (!files::exists(partialsPath))
+    {
+        return {};
+    }
+    return forEachFile(partialsPath, true,
+        [&](std::string_view pathName) -> Expected<void>
+        {
+            // Skip directories
+            MRDOCS_CHECK_OR(!files::isDirectory(pathName), {});
+
+            // Get template relative path
+            std::filesystem::path relPath = pathName;
+            relPath = relPath.lexically_relative(partialsPath);
+
+            // Skip non-handlebars files
+            MRDOCS_CHECK_OR(relPath.extension() == ".hbs", {});
+
+            // Remove any file extensions
+            while(relPath.has_extension())
+            {
+                relPath.replace_extension();
+            }
+
+            // Load partial contents
+            MRDOCS_TRY(std::string text, files::getFileText(pathName));
+
+            // Compile partial
+            std::string name = relPath.generic_string();
+            if (auto keys = findCacheKeys(text); !keys.empty())
+            {
+                cacheKeys.insert_or_assign(name, std::move(keys));
+            }
+            else
+            {
+                cacheKeys.erase(name);
+            }
+            store.partials.insert_or_assign(
+                std::move(name),
+                Handlebars::compile(text));
+            return {};
+        });
+}
+
+Expected<void>
+loadHelperScripts(
+    std::vector<std::pair<std::string, std::string>>& scripts,
+    std::string const& helpersPath,
+    std::string_view ext)
+{
+    return forEachFile(helpersPath, true,
+        [&](std::string_view pathName)-> Expected<void>
+        {
+            if (!pathName.ends_with(ext)) return {};
+            auto name = files::getFileName(pathName);
+            name.remove_suffix(ext.size());
+            MRDOCS_TRY(auto script, files::getFileText(pathName));
+            scripts.emplace_back(name, std::move(script));
+            return {};
+        });
+}
+
+} // (anon)
+
+Expected<std::vector<NativeHelper>>
+TemplateStore::
+loadHelperPlugins(std::string const& helpersDir)
+{
+    std::vector<NativeHelper> res;
+    auto exp = forEachFile(helpersDir, true,
+        [&](std::string_view pathName)-> Expected<void>
+        {
+            MRDOCS_CHECK_OR(isHelperPlugin(pathName), {});
+            MRDOCS_TRY(auto helpers, loadHelperPlugin(std::string(pathName)));
+            for (NativeHelper& helper : helpers)
+            {
+                res.push_back(std::move(helper));
+            }
+            return {};
+        });
+    MRDOCS_CHECK_OR(exp, Unexpected(exp.error()));
+    return res;
+}
+
+Expected<std::shared_ptr<TemplateStore const>>
+TemplateStore::
+create(HandlebarsCorpus const& corpus)
+{
+    auto store = std::make_shared<TemplateStore>();
+
+    // Load partials
+    std::map<std::string, std::vector<std::string>, std::less<>> cacheKeys;
+    MRDOCS_TRY(loadPartials(*store, cacheKeys, commonTemplatesDir(corpus, "partials")));
+    MRDOCS_TRY(loadPartials(*store, cacheKeys, templatesDir(corpus, "partials")));
+    if (!cacheKeys.empty())
+    {
+        store->fragments = std::make_shared<FragmentCache>(std::move(cacheKeys));
+    }
+
+    // Load native, Lua, and JavaScript helpers
+    std::string const helpersDir = templatesDir(corpus, "helpers");
+    MRDOCS_TRY(store->nativeHelpers, loadHelperPlugins(helpersDir));
+    MRDOCS_TRY(loadHelperScripts(store->luaHelperScripts, helpersDir, ".lua"));
+    MRDOCS_TRY(loadHelperScripts(store->helperScripts, helpersDir, ".js"));
+    auto const isNativeHelper = [&](std::string_view name)
+    {
+        return std::ranges::any_of(store->nativeHelpers,
+            [&](NativeHelper const& helper)
+            {
+                return helper.name == name;
+            });
+    };
+    auto const isLuaHelper = [&](std::string_view name)
+    {
+        return std::ranges::any_of(store->luaHelperScripts,
+            [&](auto const& script)
+            {
+                return script.first == name;
+            });
+    };
+    std::erase_if(store->luaHelperScripts, [&](auto const& script)
+    {
+        return isNativeHelper(script.first);
+    });
+    std::erase_if(store->helperScripts, [&](auto const& script)
+    {
+        return isNativeHelper(script.first) || isLuaHelper(script.first);
+    });
+
+    // Load layout templates
+    std::string indexTemplateFilename =
+        std::format("index.{}.hbs", corpus.fileExtension);
+    std::string wrapperTemplateFilename =
+        std::format("wrapper.{}.hbs", corpus.fileExtension);
+    std::string const layoutDir = templatesDir(corpus, "layouts");
+    for (std::string const& filename : {indexTemplateFilename, wrapperTemplateFilename})
+    {
+        std::string pathName = files::appendPath(layoutDir, filename);
+        MRDOCS_TRY(std::string text, files::getFileText(pathName));
+        store->layouts.emplace(filename, Handlebars::compile(text));
+    }
+    return std::shared_ptr<TemplateStore const>(std::move(store));
+}
+
+} // mrdocs::hbs
@@ -0,0 +1,108 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#ifndef MRDOCS_LIB_GEN_HBS_TEMPLATESTORE_HPP
+#define MRDOCS_LIB_GEN_HBS_TEMPLATESTORE_HPP
+
+#include <lib/Gen/hbs/FragmentCache.hpp>
+#include <lib/Gen/hbs/HandlebarsCorpus.hpp>
+#include <lib/Support/HelperPlugin.hpp>
+#include <mrdocs/Support/Error.hpp>
+#include <mrdocs/Support/Handlebars.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mrdocs::hbs {
+
+/** Templates shared by all builders of a generator
+
+    The partials, layouts, and helper scripts of
+    the generator are read from disk and compiled
+    once, before any @ref Builder is created.
+
+    The store is immutable once created, so the
+    builders of all threads refer to the same
+    store without synchronization.
+*/
+class TemplateStore
+{
+public:
+    /** Compiled partials by name
+
+        Partials from the generator directory
+        replace common partials with the same name.
+     */
+    std::map<std::string, HandlebarsTemplate, std::less<>> partials;
+
+    /** Compiled layout templates by file name
+     */
+    std::map<std::string, HandlebarsTemplate, std::less<>> layouts;
+
+    /** JavaScript helper names and scripts
+
+        Scripts are compiled by each builder because
+        each thread has its own JavaScript context.
+        Scripts shadowed by a native or Lua helper
+        are not included.
+     */
+    std::vector<std::pair<std::string, std::string>> helperScripts;
+
+    /** Lua helper names and scripts
+
+        Scripts are loaded by each builder because
+        each thread has its own Lua state. Scripts
+        shadowed by a native helper are not included.
+     */
+    std::vector<std::pair<std::string, std::string>> luaHelperScripts;
+
+    /** Helpers from native plugins
+
+        The plugins are loaded once and their
+        functions are shared by all builders.
+     */
+    std::vector<NativeHelper> nativeHelpers;
+
+    /** Rendered partials shared by all builders
+
+        This is null unless a partial declares a
+        cache key. The cache is synchronized, so
+        the builders can use it concurrently.
+     */
+    std::shared_ptr<FragmentCache> fragments;
+
+    /** Load the native helper plugins in a directory
+
+        @param helpersDir The `helpers` directory
+        of a generator
+        @return The helpers exported by the plugins
+        in the directory, or an error if a plugin
+        could not be loaded.
+     */
+    static
+    Expected<std::vector<NativeHelper>>
+    loadHelperPlugins(std::string const& helpersDir);
+
+    /** Load the templates for a generator.
+
+        @param corpus The corpus being generated
+        @return The store or an error if a template
+        could not be loaded.
+     */
+    static
+    Expected<std::shared_ptr<TemplateStore const>>
+    create(HandlebarsCorpus const& corpus);
+};
+
+} // mrdocs::hbs
+
+#endif // MRDOCS_LIB_GEN_HBS_TEMPLATESTORE_HPP
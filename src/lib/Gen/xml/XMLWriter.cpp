@@ -16,7 +16,12 @@
 #include "CXXTags.hpp"
 #include <lib/Support/LegibleNames.hpp>
 #include <lib/Support/Radix.hpp>
+#include <mrdocs/Support/ThreadPool.hpp>
 #include <llvm/Support/YAMLTraits.h>
+#include <llvm/Support/raw_ostream.h>
+#include <deque>
+#include <string>
+#include <vector>
 
 //------------------------------------------------
 //
@@ -32,6 +37,93 @@ namespace mrdocs::xml {
 //
 //------------------------------------------------
 
+/*  Members of namespaces rendered concurrently
+
+    The namespace writer writes to a text buffer.
+    When it reaches a member which is not a
+    namespace, the text so far becomes a segment,
+    and the member is rendered into the next
+    segment by a task. Segments are written to
+    the output in order once their tasks are
+    done, which happens whenever there are too
+    many pending segments and at the end.
+*/
+class XMLWriter::Subtrees
+{
+    static constexpr std::size_t maxSegments = 4096;
+
+    TaskGroup tasks_;
+    Corpus const& corpus_;
+    llvm::raw_ostream& out_;
+    llvm::raw_string_ostream& textOS_;
+    std::string& text_;
+    std::deque<std::string> segments_;
+    std::vector<Error> errors_;
+
+    void
+    pushText()
+    {
+        textOS_.flush();
+        segments_.push_back(std::move(text_));
+        text_.clear();
+    }
+
+public:
+    Subtrees(
+        ThreadPool& threadPool,
+        Corpus const& corpus,
+        llvm::raw_ostream& out,
+        llvm::raw_string_ostream& textOS,
+        std::string& text)
+        : tasks_(threadPool)
+        , corpus_(corpus)
+        , out_(out)
+        , textOS_(textOS)
+        , text_(text)
+    {
+    }
+
+    void
+    defer(Symbol const& I, std::string const& indent)
+    {
+        pushText();
+        // Deque elements are not invalidated by push_back
+        std::string& dest = segments_.emplace_back();
+        tasks_.async([this, &I, &dest, indent]
+        {
+            llvm::raw_string_ostream os(dest);
+            XMLWriter writer(os, corpus_);
+            writer.tags_.indent_ = indent;
+            visit(I, writer);
+        });
+        if (segments_.size() >= maxSegments)
+        {
+            flush();
+        }
+    }
+
+    void
+    flush()
+    {
+        pushText();
+        auto errors = tasks_.wait();
+        errors_.insert(errors_.end(), errors.begin(), errors.end());
+        for (std::string const& segment : segments_)
+        {
+            out_ << segment;
+        }
+        segments_.clear();
+    }
+
+    Expected<void>
+    finish()
+    {
+        flush();
+        MRDOCS_CHECK_OR(errors_.empty(), Unexpected(errors_));
+        return {};
+    }
+};
+
 XMLWriter::
 XMLWriter(
     llvm::raw_ostream& os,
@@ -51,7 +143,22 @@ build()
         "<mrdocs xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n"
         "       xsi:noNamespaceSchemaLocation=\"https://github.com/cppalliance/mrdocs/raw/develop/mrdocs.rnc\">\n";
 
-    this->operator()(corpus_.globalNamespace());
+    ThreadPool& threadPool = corpus_.config.threadPool();
+    if (threadPool.getThreadCount() == 1)
+    {
+        this->operator()(corpus_.globalNamespace());
+    }
+    else
+    {
+        std::string text;
+        llvm::raw_string_ostream textOS(text);
+        Subtrees subtrees(threadPool, corpus_, os_, textOS, text);
+        XMLWriter writer(textOS, corpus_);
+        writer.tags_.indent_ = tags_.indent_;
+        writer.subtrees_ = &subtrees;
+        writer(corpus_.globalNamespace());
+        MRDOCS_TRY(subtrees.finish());
+    }
 
     os_ << "</mrdocs>\n";
 
@@ -68,6 +175,14 @@ operator()(SymbolTy const& I)
     {
         return;
     }
+    if constexpr (!SymbolTy::isNamespace())
+    {
+        if (subtrees_)
+        {
+            subtrees_->defer(I, tags_.indent_);
+            return;
+        }
+    }
     #define INFO(Type) if constexpr(SymbolTy::is##Type()) write##Type(I);
 #include <mrdocs/Metadata/Symbol/SymbolNodes.inc>
 }
@@ -35,11 +35,27 @@ protected:
     llvm::raw_ostream& os_;
     Corpus const& corpus_;
 
+    class Subtrees;
+
+    // Set while the members of namespaces
+    // are rendered concurrently
+    Subtrees* subtrees_ = nullptr;
+
 public:
     XMLWriter(
         llvm::raw_ostream& os,
         Corpus const& corpus) noexcept;
 
+    /** Write the XML document for the corpus.
+
+        When the thread pool of the configuration
+        has more than one thread, namespaces are
+        written by the calling thread while their
+        other members are rendered concurrently
+        into separate buffers. The buffers are
+        written in order, so the output is the
+        same as with a single thread.
+     */
     Expected<void>
     build();
 
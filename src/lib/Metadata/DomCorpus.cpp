@@ -15,7 +15,15 @@
 #include <mrdocs/Metadata.hpp>
 #include <mrdocs/Metadata/DocComment.hpp>
 #include <mrdocs/Metadata/DomCorpus.hpp>
+#include <algorithm>
+#include <array>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace mrdocs {
 
@@ -23,8 +31,39 @@ class DomCorpus::Impl
 {
     using value_type = std::weak_ptr<dom::ObjectImpl>;
 
+    /* A partition of the object cache
+
+       Symbols are distributed over the shards by
+       their ID, so threads requesting different
+       symbols rarely contend for the same lock.
+     */
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<SymbolID, value_type> objects;
+
+        // Expired entries are erased when the
+        // number of objects reaches this size
+        std::size_t pruneAt = minPruneAt;
+
+        // Objects kept alive by the cache. When
+        // full, the oldest object is replaced.
+        std::vector<dom::Object> retained;
+        std::size_t nextRetained = 0;
+    };
+
+    static constexpr std::size_t shardCount = 16;
+
+    // The maximum number of objects kept alive in
+    // each shard. Objects above this limit are only
+    // shared while something else refers to them.
+    static constexpr std::size_t maxRetained = 4096;
+
+    static constexpr std::size_t minPruneAt = 2 * maxRetained;
+
     DomCorpus const& domCorpus_;
     Corpus const& corpus_;
+    mutable std::array<Shard, shardCount> shards_;
 
 public:
     Impl(
@@ -50,11 +89,66 @@ public:
     dom::Object
     get(SymbolID const& id) const
     {
+        Shard& shard = shards_[std::hash<SymbolID>()(id) % shardCount];
+        {
+            std::lock_guard lock(shard.mutex);
+            if (auto it = shard.objects.find(id);
+                it != shard.objects.end())
+            {
+                if (auto impl = it->second.lock())
+                {
+                    return dom::Object(std::move(impl));
+                }
+            }
+        }
+
         // VFALCO Hack to deal with symbol IDs
         // being emitted without the corresponding data.
         Symbol const* I = corpus_.find(id);
         MRDOCS_CHECK_OR(I, {});
-        return create(*I);
+
+        // Construct the object without holding the lock.
+        // If another thread stored an object for the same
+        // symbol in the meantime, that object is used
+        // instead so all references share one object.
+        dom::Object obj = create(*I);
+
+        // An evicted object is released after the lock,
+        // as destroying it can release a large graph of
+        // memoized values
+        std::optional<dom::Object> evicted;
+        std::lock_guard lock(shard.mutex);
+        if (auto it = shard.objects.find(id);
+            it != shard.objects.end())
+        {
+            if (auto impl = it->second.lock())
+            {
+                return dom::Object(std::move(impl));
+            }
+        }
+        if (shard.objects.size() >= shard.pruneAt)
+        {
+            std::erase_if(shard.objects, [](auto const& entry)
+            {
+                return entry.second.expired();
+            });
+            shard.pruneAt = std::max(minPruneAt, 2 * shard.objects.size());
+        }
+        shard.objects.insert_or_assign(id, obj.impl());
+
+        // The evicted object, and the values it memoized,
+        // are destroyed unless something else still
+        // refers to them
+        if (shard.retained.size() < maxRetained)
+        {
+            shard.retained.push_back(obj);
+        }
+        else
+        {
+            evicted = std::exchange(shard.retained[shard.nextRetained], obj);
+            shard.nextRetained = (shard.nextRetained + 1) % maxRetained;
+        }
+        return obj;
     }
 };
 
@@ -115,8 +209,7 @@ getParents(DomCorpus const& C, Symbol const& I)
     dom::Array res;
     for (SymbolID const& id : pIds)
     {
-        Symbol const& PI = corpus.get(id);
-        res.push_back(C.construct(PI));
+        res.push_back(C.get(id));
     }
     return res;
 }
@@ -11,7 +11,10 @@
 #include <lib/Metadata/Finalizers/DerivedFinalizer.hpp>
 #include <mrdocs/Support/Algorithm.hpp>
 #include <mrdocs/Support/Report.hpp>
+#include <mrdocs/Support/ThreadPool.hpp>
 #include <algorithm>
+#include <string_view>
+#include <unordered_map>
 
 namespace mrdocs {
 
@@ -19,6 +22,9 @@ void
 DerivedFinalizer::
 build()
 {
+    // Collect the public derived records of each base.
+    // Lists are only sorted once all pairs are known.
+    std::unordered_map<SymbolID, std::vector<SymbolID>> derivedByBase;
     for (auto& I : corpus_.info_)
     {
         MRDOCS_ASSERT(I);
@@ -40,28 +46,61 @@ build()
             MRDOCS_CHECK_OR_CONTINUE(baseInfoPtr);
             MRDOCS_CHECK_OR_CONTINUE(baseInfoPtr->isRecord());
             MRDOCS_CHECK_OR_CONTINUE(baseInfoPtr->Extraction == ExtractionMode::Regular);
-            if (auto& baseRecord = baseInfoPtr->asRecord();
-                !contains(baseRecord.Derived, record.id))
-            {
-                // Insert in order by name
-                auto const it = std::ranges::lower_bound(
-                    baseRecord.Derived,
-                    record.id,
-                    [&](SymbolID const& lhs, SymbolID const& rhs) {
-                        auto const* lhsRecord = corpus_.find(lhs);
-                        auto const* rhsRecord = corpus_.find(rhs);
-                        MRDOCS_ASSERT(lhsRecord);
-                        MRDOCS_ASSERT(rhsRecord);
-                        if (lhsRecord->Name != rhsRecord->Name)
-                        {
-                            return lhsRecord->Name < rhsRecord->Name;
-                        }
-                        return lhs < rhs;
-                });
-                baseRecord.Derived.insert(it, record.id);
-            }
+            derivedByBase[baseInfoPtr->id].push_back(record.id);
         }
     }
+
+    // Sort the derived records of each base.
+    // The lists are independent, so they are
+    // sorted concurrently.
+    TaskGroup taskGroup(corpus_.config_->threadPool());
+    for (auto& [baseID, derivedIDs] : derivedByBase)
+    {
+        Symbol* baseInfoPtr = corpus_.find(baseID);
+        MRDOCS_ASSERT(baseInfoPtr);
+        RecordSymbol& baseRecord = baseInfoPtr->asRecord();
+        taskGroup.async(
+            [this, &baseRecord, &derivedIDs]
+            {
+                setDerived(baseRecord, derivedIDs);
+            });
+    }
+    for (Error const& err : taskGroup.wait())
+    {
+        report::error("{}", err);
+    }
+}
+
+void
+DerivedFinalizer::
+setDerived(
+    RecordSymbol& base,
+    std::vector<SymbolID> const& derivedIDs) const
+{
+    // Look up the name of each record once
+    // instead of on every comparison.
+    std::vector<std::pair<std::string_view, SymbolID>> keys;
+    keys.reserve(base.Derived.size() + derivedIDs.size());
+    auto addKey = [&](SymbolID const& id)
+    {
+        Symbol const* derived = corpus_.find(id);
+        MRDOCS_ASSERT(derived);
+        keys.emplace_back(derived->Name, id);
+    };
+    std::ranges::for_each(base.Derived, addKey);
+    std::ranges::for_each(derivedIDs, addKey);
+
+    // Order by name, then by symbol ID
+    std::ranges::sort(keys);
+    auto const [first, last] = std::ranges::unique(keys);
+    keys.erase(first, last);
+
+    base.Derived.clear();
+    base.Derived.reserve(keys.size());
+    for (auto const& key: keys)
+    {
+        base.Derived.push_back(key.second);
+    }
 }
 
 } // mrdocs
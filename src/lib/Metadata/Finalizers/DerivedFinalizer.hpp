@@ -28,6 +28,16 @@ class DerivedFinalizer
 {
     CorpusImpl& corpus_;
 
+    /*  Set the sorted list of derived records of a base
+
+        The new records are merged with any existing
+        records and the list is sorted by name.
+     */
+    void
+    setDerived(
+        RecordSymbol& base,
+        std::vector<SymbolID> const& derivedIDs) const;
+
 public:
     DerivedFinalizer(CorpusImpl& corpus)
         : corpus_(corpus)
@@ -28,14 +28,23 @@ void
 DocCommentFinalizer::
 build()
 {
+    for (auto const& ptr: corpus_.info_)
+    {
+        MRDOCS_CHECK_OR_CONTINUE(ptr);
+        MRDOCS_CHECK_OR_CONTINUE(ptr->Extraction != ExtractionMode::Dependency);
+        indexOf(*ptr);
+    }
+
+    // Order the symbols so that the sources of @copy*
+    // commands are finalized before the symbols that
+    // copy from them. The finalization steps then find
+    // their sources already finalized and don't recurse.
+    std::vector<std::size_t> const ordered = sortByDependencies();
     auto infos =
-        corpus_.info_ |
-        std::views::filter([](std::unique_ptr<Symbol> const& ptr) {
-            return ptr && ptr->Extraction != ExtractionMode::Dependency;
-        }) |
-        std::views::transform([](std::unique_ptr<Symbol> const& ptr) -> Symbol& {
-            MRDOCS_ASSERT(ptr);
-            return *ptr;
+        ordered |
+        std::views::transform([this](std::size_t i) -> Symbol& {
+            MRDOCS_ASSERT(symbols_[i]);
+            return *symbols_[i];
         });
 
     // Finalize briefs:
@@ -43,9 +52,9 @@ build()
     // the brief of other functions, these often need to be resolved
     // with @copybrief or auto-brief, and we need to ensure that
     // there are no circular dependencies for other metadata.
-    for (auto& I : infos)
+    for (std::size_t i : ordered)
     {
-        finalizeBrief(I);
+        finalizeBrief(i);
     }
 
     // Finalize metadata:
@@ -57,9 +66,9 @@ build()
     // for all objects to generate doc for overloads.
     // For instance, overloads cannot aggregate function
     // parameters as if the parameters are not resolved.
-    for (auto& I : infos)
+    for (std::size_t i : ordered)
     {
-        copyDetails(I);
+        copyDetails(i);
     }
 
     // Create doc for overloads:
@@ -80,11 +89,11 @@ build()
     // We do this before resolving overloads because a reference
     // to a function without signature should resolve to the
     // overload set, not to a specific function.
-    for (auto& I : infos)
+    for (std::size_t i : ordered)
     {
         // Rename this to "finalizeReferences" and move other
         // functionality to other loops.
-        resolveReferences(I);
+        resolveReferences(i);
     }
 
     // Populate trivial function metadata
@@ -136,12 +145,141 @@ build()
     emitWarnings();
 }
 
+std::size_t
+DocCommentFinalizer::
+indexOf(Symbol const& I)
+{
+    auto [it, inserted] = index_.try_emplace(&I, symbols_.size());
+    if (inserted)
+    {
+        symbols_.push_back(const_cast<Symbol*>(&I));
+        state_.push_back(0);
+    }
+    return it->second;
+}
+
+void
+DocCommentFinalizer::
+findCopySources(
+    Symbol const& I,
+    std::vector<std::size_t>& sources)
+{
+    auto addSymbol = [&](SymbolID const& id)
+    {
+        Symbol const* src = corpus_.find(id);
+        MRDOCS_CHECK_OR(src);
+        sources.push_back(indexOf(*src));
+    };
+    auto addRef = [&](std::string_view ref)
+    {
+        auto resRef = corpus_.lookup(I.id, ref);
+        MRDOCS_CHECK_OR(resRef);
+        Symbol const& res = *resRef;
+        sources.push_back(indexOf(res));
+        // Metadata is copied from each function
+        // of an overload set
+        if (auto const* OI = res.asOverloadsPtr())
+        {
+            std::ranges::for_each(OI->Members, addSymbol);
+        }
+    };
+
+    // Overload sets depend on their members
+    if (auto const* OI = I.asOverloadsPtr())
+    {
+        std::ranges::for_each(OI->Members, addSymbol);
+    }
+
+    MRDOCS_CHECK_OR(I.doc);
+    DocComment const& doc = *I.doc;
+    if (doc.brief)
+    {
+        std::ranges::for_each(doc.brief->copiedFrom, addRef);
+    }
+    for (auto const& block: doc.Document)
+    {
+        MRDOCS_CHECK_OR_CONTINUE(block->isParagraph());
+        for (auto const& text: block->asParagraph().children)
+        {
+            MRDOCS_CHECK_OR_CONTINUE(text->isCopyDetails());
+            addRef(text->asCopyDetails().string);
+        }
+    }
+}
+
+std::vector<std::size_t>
+DocCommentFinalizer::
+sortByDependencies()
+{
+    // Iterative depth-first traversal of the copy
+    // dependencies, emitting symbols in post-order.
+    // Symbols found through references are appended
+    // to symbols_ while the graph is being built.
+    enum : std::uint8_t { Unvisited, Visiting, Visited };
+    std::vector<std::uint8_t> mark;
+    std::vector<std::vector<std::size_t>> sources;
+    std::vector<std::size_t> order;
+    order.reserve(symbols_.size());
+
+    struct Frame
+    {
+        std::size_t index;
+        std::size_t next = 0;
+    };
+    std::vector<Frame> stack;
+    std::size_t const n = index_.size();
+    for (std::size_t root = 0; root < n; ++root)
+    {
+        if (mark.size() < symbols_.size())
+        {
+            mark.resize(symbols_.size(), Unvisited);
+        }
+        MRDOCS_CHECK_OR_CONTINUE(mark[root] == Unvisited);
+        stack.push_back({root});
+        while (!stack.empty())
+        {
+            Frame& frame = stack.back();
+            std::size_t const i = frame.index;
+            if (frame.next == 0 && mark[i] == Unvisited)
+            {
+                mark[i] = Visiting;
+                if (sources.size() <= i)
+                {
+                    sources.resize(i + 1);
+                }
+                std::vector<std::size_t> deps;
+                findCopySources(*symbols_[i], deps);
+                sources[i] = std::move(deps);
+                mark.resize(symbols_.size(), Unvisited);
+            }
+            if (frame.next < sources[i].size())
+            {
+                std::size_t const dep = sources[i][frame.next++];
+                // Visiting symbols are in a cycle: skip them
+                if (mark[dep] == Unvisited)
+                {
+                    stack.push_back({dep});
+                }
+                continue;
+            }
+            mark[i] = Visited;
+            order.push_back(i);
+            stack.pop_back();
+        }
+    }
+
+    // Symbols that were only reached through
+    // references are not part of the result
+    std::erase_if(order, [n](std::size_t i) { return i >= n; });
+    return order;
+}
+
 void
 DocCommentFinalizer::
-finalizeBrief(Symbol& I)
+finalizeBrief(std::size_t const i)
 {
-    MRDOCS_CHECK_OR(!finalized_brief_.contains(&I));
-    finalized_brief_.emplace(&I);
+    MRDOCS_CHECK_OR(markFinalized(i, BriefFinalized));
+    Symbol& I = *symbols_[i];
 
     report::trace(
             "Finalizing brief for '{}'",
@@ -283,10 +421,10 @@ setAutoBrief(DocComment& doc) const
 
 void
 DocCommentFinalizer::
-copyDetails(Symbol& I)
+copyDetails(std::size_t const i)
 {
-    MRDOCS_CHECK_OR(!finalized_metadata_.contains(&I));
-    finalized_metadata_.emplace(&I);
+    MRDOCS_CHECK_OR(markFinalized(i, MetadataFinalized));
+    Symbol& I = *symbols_[i];
 
     report::trace(
             "Finalizing metadata for '{}'",
@@ -736,10 +874,10 @@ DocCommentFinalizer::generateOverloadDocs(OverloadsSymbol& I)
 }
 
 void
-DocCommentFinalizer::resolveReferences(Symbol& I)
+DocCommentFinalizer::resolveReferences(std::size_t const i)
 {
-    MRDOCS_CHECK_OR(!finalized_.contains(&I));
-    finalized_.emplace(&I);
+    MRDOCS_CHECK_OR(markFinalized(i, ReferencesFinalized));
+    Symbol& I = *symbols_[i];
 
     report::trace(
         "Finalizing doc for '{}'",
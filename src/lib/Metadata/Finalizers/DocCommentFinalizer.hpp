@@ -16,9 +16,12 @@
 #include <lib/Metadata/SymbolSet.hpp>
 #include <mrdocs/Support/Report.hpp>
 #include <mrdocs/Support/ScopeExit.hpp>
+#include <cstdint>
 #include <format>
 #include <set>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace mrdocs {
 
@@ -38,20 +41,37 @@ class DocCommentFinalizer {
      */
     std::set<std::pair<std::string, std::string>> refWarned_;
 
-    /* Info objects whose briefs have been finalized
+    /* Finalization steps tracked for each symbol
      */
-    std::set<Symbol const*> finalized_brief_;
+    enum FinalizedStep : std::uint8_t
+    {
+        // The brief has been finalized
+        BriefFinalized = 1 << 0,
+        // The metadata has been finalized
+        MetadataFinalized = 1 << 1,
+        // The references have been resolved
+        ReferencesFinalized = 1 << 2
+    };
+
+    /* Symbols by dense index
+     */
+    std::vector<Symbol*> symbols_;
+
+    /* The dense index of each symbol in the state table
 
-    /* Info objects whose metadata has been finalized
+        The finalization loops use the dense indices
+        directly. This is only used to find the index
+        of the sources of a symbol, such as the targets
+        of @copydoc or the members of an overload set.
      */
-    std::set<Symbol const*> finalized_metadata_;
+    std::unordered_map<Symbol const*, std::size_t> index_;
 
-    /* Info objects that have been finalized
+    /* The finalized steps of each symbol, by dense index
 
-        This is used to avoid recursion when finalizing
-        references.
+        This is used to avoid recursion when a step
+        requires the same step for another symbol.
      */
-    std::set<Symbol const*> finalized_;
+    std::vector<std::uint8_t> state_;
 
     // A comparison function that sorts locations by:
     // 1) ascending full path
@@ -100,14 +120,63 @@ public:
     build();
 
 private:
+    /*  Return the dense index of a symbol
+
+        Symbols reached through references that are
+        not part of the initial set get a new index.
+     */
+    std::size_t
+    indexOf(Symbol const& I);
+
+    /*  Mark a finalization step of a symbol as done
+
+        @param i The dense index of the symbol
+        @return `false` if the step was already done.
+     */
+    bool
+    markFinalized(std::size_t i, FinalizedStep step)
+    {
+        std::uint8_t& state = state_[i];
+        MRDOCS_CHECK_OR(!(state & step), false);
+        state |= step;
+        return true;
+    }
+
+    /*  Return the indices of the symbols with copy sources first
+
+        This builds the graph of @copydoc, @copybrief and
+        @copydetails dependencies, including overload sets
+        depending on their members, and returns the symbols
+        indexed so far in a topological order of this graph.
+        Symbols in a cycle keep an arbitrary order among
+        themselves.
+     */
+    std::vector<std::size_t>
+    sortByDependencies();
+
+    /*  Append the copy sources of a symbol to a list
+     */
+    void
+    findCopySources(
+        Symbol const& I,
+        std::vector<std::size_t>& sources);
+
     /*  Finalize the brief of a symbol
 
         This might mean copying the brief from another
         symbol (when there's a copybrief command) or
         populating it automatically (first sentence).
+
+        @param i The dense index of the symbol
      */
     void
-    finalizeBrief(Symbol& I);
+    finalizeBrief(std::size_t i);
+
+    void
+    finalizeBrief(Symbol& I)
+    {
+        finalizeBrief(indexOf(I));
+    }
 
     void
     copyBrief(Symbol const& ctx, DocComment& doc);
@@ -121,9 +190,17 @@ private:
         the current symbol context whenever the current
         context contains a reference to another symbol
         created with \@copydoc or \@copydetails.
+
+        @param i The dense index of the symbol
      */
     void
-    copyDetails(Symbol& I);
+    copyDetails(std::size_t i);
+
+    void
+    copyDetails(Symbol& I)
+    {
+        copyDetails(indexOf(I));
+    }
 
     void
     copyDetails(Symbol const& ctx, DocComment& doc);
@@ -145,9 +222,17 @@ private:
         The references are resolved by looking
         up the symbol in the corpus and setting the ID of
         the reference.
+
+        @param i The dense index of the symbol
      */
     void
-    resolveReferences(Symbol& I);
+    resolveReferences(std::size_t i);
+
+    void
+    resolveReferences(Symbol& I)
+    {
+        resolveReferences(indexOf(I));
+    }
 
     void
     resolveReference(
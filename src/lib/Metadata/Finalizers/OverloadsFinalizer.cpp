@@ -13,105 +13,108 @@
 
 namespace mrdocs {
 
-namespace {
+void
+OverloadsFinalizer::
+indexOverloads(
+    SymbolID const& contextId,
+    std::vector<SymbolID> const& functionIds)
+{
+    auto& contextIndex = overloadsIndex_[contextId];
+    for (SymbolID const& id: functionIds)
+    {
+        Symbol const* info = corpus_.find(id);
+        MRDOCS_CHECK_OR_CONTINUE(info);
+        auto const* overloads = info->asOverloadsPtr();
+        MRDOCS_CHECK_OR_CONTINUE(overloads);
+        contextIndex.emplace(overloads->MembersHash, id);
+    }
+}
+
 SymbolID
+OverloadsFinalizer::
+findIndexedPermutation(
+    SymbolID const& contextId,
+    llvm::ArrayRef<SymbolID> sameNameFunctionIds,
+    std::size_t const sameNameHash) const
+{
+    auto const contextIt = overloadsIndex_.find(contextId);
+    MRDOCS_CHECK_OR(contextIt != overloadsIndex_.end(), SymbolID::invalid);
+    auto [first, last] = contextIt->second.equal_range(sameNameHash);
+    for (auto const& [hash, overloadsId]: std::ranges::subrange(first, last))
+    {
+        Symbol const* info = corpus_.find(overloadsId);
+        MRDOCS_CHECK_OR_CONTINUE(info);
+        auto const* overloads = info->asOverloadsPtr();
+        MRDOCS_CHECK_OR_CONTINUE(overloads);
+        // The fingerprints match: confirm this overload
+        // set has the same functions
+        MRDOCS_CHECK_OR_CONTINUE(
+            overloads->Members.size() == sameNameFunctionIds.size());
+        MRDOCS_CHECK_OR_CONTINUE(
+            std::ranges::is_permutation(
+                overloads->Members,
+                sameNameFunctionIds));
+        return overloadsId;
+    }
+    return SymbolID::invalid;
+}
+
+SymbolID
+OverloadsFinalizer::
 findBaseClassPermutation(
     SymbolID const& contextId,
-    CorpusImpl& corpus,
-    llvm::ArrayRef<SymbolID> sameNameFunctionIds)
+    llvm::ArrayRef<SymbolID> sameNameFunctionIds,
+    std::size_t const sameNameHash) const
 {
     // Find the RecordSymbol
-    Symbol* info = corpus.find(contextId);
+    Symbol const* info = corpus_.find(contextId);
     MRDOCS_CHECK_OR(info, SymbolID::invalid);
     MRDOCS_CHECK_OR(info->isRecord(), SymbolID::invalid);
     for (auto const& base: info->asRecordPtr()->Bases)
     {
-        // Find the i-th base class
+        // Find an overload set of the i-th base class
+        // that's a permutation of the same name functions
         MRDOCS_CHECK_OR(base.Type, SymbolID::invalid);
-        auto const baseInfo = corpus.find(base.Type->namedSymbol());
-        MRDOCS_CHECK_OR_CONTINUE(baseInfo);
-        auto const baseRecord = baseInfo->asRecordPtr();
-        MRDOCS_CHECK_OR_CONTINUE(baseRecord);
-
-        // Iterate over all function tranches
-        RecordTranche* tranchesPtrs[] = {
-            &baseRecord->Interface.Public,
-            &baseRecord->Interface.Protected,
-            &baseRecord->Interface.Private,
-        };
-        for (RecordTranche* tranchePtr: tranchesPtrs)
-        {
-            std::vector<SymbolID>* trancheFunctionPtrs[] = {
-                &tranchePtr->Functions,
-                &tranchePtr->StaticFunctions
-            };
-            for (std::vector<SymbolID>* trancheFunctionsPtr:
-                 trancheFunctionPtrs)
-            {
-                // Find an overload set that's a permutation of the same
-                // name functions
-                for (SymbolID const& baseID: *trancheFunctionsPtr)
-                {
-                    Symbol* baseFuncMember = corpus.find(baseID);
-                    MRDOCS_CHECK_OR_CONTINUE(baseFuncMember);
-                    MRDOCS_CHECK_OR_CONTINUE(baseFuncMember->isOverloads());
-                    auto* overloads = baseFuncMember->asOverloadsPtr();
-                    MRDOCS_CHECK_OR_CONTINUE(overloads);
-                    // Does this overload set have the same functions
-                    MRDOCS_CHECK_OR_CONTINUE(
-                        std::ranges::is_permutation(
-                            overloads->Members,
-                            sameNameFunctionIds));
-                    return overloads->id;
-                }
-            }
-        }
+        SymbolID const overloadsId = findIndexedPermutation(
+            base.Type->namedSymbol(),
+            sameNameFunctionIds,
+            sameNameHash);
+        MRDOCS_CHECK_OR_CONTINUE(overloadsId);
+        return overloadsId;
     }
     return SymbolID::invalid;
 }
 
 SymbolID
+OverloadsFinalizer::
 findIntroducedNamespacePermutation(
     SymbolID const& contextId,
-    CorpusImpl& corpus,
-    llvm::ArrayRef<SymbolID> sameNameFunctionIds)
+    llvm::ArrayRef<SymbolID> sameNameFunctionIds,
+    std::size_t const sameNameHash) const
 {
     // Find the UsingSymbol
-    Symbol* info = corpus.find(contextId);
+    Symbol const* info = corpus_.find(contextId);
     MRDOCS_CHECK_OR(info, SymbolID::invalid);
     MRDOCS_CHECK_OR(info->isUsing(), SymbolID::invalid);
 
     // Find the FunctionSymbol for the first shadow declaration
     MRDOCS_CHECK_OR(!sameNameFunctionIds.empty(), SymbolID::invalid);
-    Symbol* firstShadowInfo = corpus.find(sameNameFunctionIds.front());
+    Symbol const* firstShadowInfo = corpus_.find(sameNameFunctionIds.front());
     MRDOCS_CHECK_OR(firstShadowInfo, SymbolID::invalid);
     MRDOCS_CHECK_OR(firstShadowInfo->isFunction(), SymbolID::invalid);
-    auto* firstShadowFunction = firstShadowInfo->asFunctionPtr();
+    auto const* firstShadowFunction = firstShadowInfo->asFunctionPtr();
 
     // Find the introduced namespace of the first shadow declaration
     MRDOCS_CHECK_OR(firstShadowFunction->Parent, SymbolID::invalid);
-    Symbol* parentInfo = corpus.find(firstShadowFunction->Parent);
+    Symbol const* parentInfo = corpus_.find(firstShadowFunction->Parent);
     MRDOCS_CHECK_OR(parentInfo, SymbolID::invalid);
     MRDOCS_CHECK_OR(parentInfo->isNamespace(), SymbolID::invalid);
-    auto* parentNamespace = parentInfo->asNamespacePtr();
 
     // Find an overload set that's a permutation of the same name functions
-    for (SymbolID const& baseID: parentNamespace->Members.Functions)
-    {
-        Symbol* baseFuncMember = corpus.find(baseID);
-        MRDOCS_CHECK_OR_CONTINUE(baseFuncMember);
-        MRDOCS_CHECK_OR_CONTINUE(baseFuncMember->isOverloads());
-        auto* overloads = baseFuncMember->asOverloadsPtr();
-        MRDOCS_CHECK_OR_CONTINUE(overloads);
-        // Does this overload set have the same functions
-        MRDOCS_CHECK_OR_CONTINUE(
-            std::ranges::is_permutation(
-                overloads->Members,
-                sameNameFunctionIds));
-        return overloads->id;
-    }
-    return SymbolID::invalid;
-}
+    return findIndexedPermutation(
+        parentInfo->id,
+        sameNameFunctionIds,
+        sameNameHash);
 }
 
 void
@@ -153,6 +156,8 @@ foldOverloads(SymbolID const& contextId, std::vector<SymbolID>& functionIds, boo
         llvm::SmallVector<SymbolID, 16> sameNameFunctionIds(
             sameNameFunctionIdsView.begin(),
             sameNameFunctionIdsView.end());
+        std::size_t const sameNameHash =
+            hashOverloadMembers(sameNameFunctionIds);
 
         // Check if any of the base classes has an overload set
         // with the exact same function ids. If that's the case,
@@ -161,8 +166,8 @@ foldOverloads(SymbolID const& contextId, std::vector<SymbolID>& functionIds, boo
         {
             SymbolID equivalentOverloadsID = findBaseClassPermutation(
                 contextId,
-                corpus_,
-                sameNameFunctionIds);
+                sameNameFunctionIds,
+                sameNameHash);
             if (equivalentOverloadsID)
             {
                 MRDOCS_ASSERT(corpus_.find(equivalentOverloadsID));
@@ -189,8 +194,8 @@ foldOverloads(SymbolID const& contextId, std::vector<SymbolID>& functionIds, boo
         {
             SymbolID introducedOverloadsID = findIntroducedNamespacePermutation(
                 contextId,
-                corpus_,
-                sameNameFunctionIds);
+                sameNameFunctionIds,
+                sameNameHash);
             if (introducedOverloadsID)
             {
                 MRDOCS_ASSERT(corpus_.find(introducedOverloadsID));
@@ -231,6 +236,10 @@ foldOverloads(SymbolID const& contextId, std::vector<SymbolID>& functionIds, boo
         functionIdIt = functionIds.begin() + itOffset;
         MRDOCS_ASSERT(corpus_.info_.emplace(std::make_unique<OverloadsSymbol>(std::move(O))).second);
     }
+
+    // Index the overload sets of this context so that derived
+    // records and using declarations can find them by fingerprint
+    indexOverloads(contextId, functionIds);
 }
 
 namespace {
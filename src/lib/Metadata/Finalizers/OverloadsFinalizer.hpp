@@ -13,6 +13,8 @@
 
 #include <lib/CorpusImpl.hpp>
 #include <lib/Metadata/SymbolSet.hpp>
+#include <llvm/ADT/ArrayRef.h>
+#include <unordered_map>
 
 namespace mrdocs {
 
@@ -29,12 +31,54 @@ class OverloadsFinalizer
     CorpusImpl& corpus_;
     std::set<SymbolID> finalized_;
 
+    /*  Overload sets of each context keyed on their fingerprint
+
+        The fingerprint is the order-independent hash of the
+        members of the overload set. Looking up a set of
+        functions in this index replaces a permutation check
+        against each overload set of the context.
+     */
+    std::unordered_map<
+        SymbolID,
+        std::unordered_multimap<std::size_t, SymbolID>> overloadsIndex_;
+
     void
     foldOverloads(
         SymbolID const& contextId,
         std::vector<SymbolID>& functionIds,
         bool isStatic);
 
+    /*  Add the overload sets among the functions of a context to the index
+     */
+    void
+    indexOverloads(
+        SymbolID const& contextId,
+        std::vector<SymbolID> const& functionIds);
+
+    /*  Find an overload set of a context with the same functions
+     */
+    SymbolID
+    findIndexedPermutation(
+        SymbolID const& contextId,
+        llvm::ArrayRef<SymbolID> sameNameFunctionIds,
+        std::size_t sameNameHash) const;
+
+    /*  Find an overload set of a base class with the same functions
+     */
+    SymbolID
+    findBaseClassPermutation(
+        SymbolID const& contextId,
+        llvm::ArrayRef<SymbolID> sameNameFunctionIds,
+        std::size_t sameNameHash) const;
+
+    /*  Find an overload set of the namespace introduced by a using declaration
+     */
+    SymbolID
+    findIntroducedNamespacePermutation(
+        SymbolID const& contextId,
+        llvm::ArrayRef<SymbolID> sameNameFunctionIds,
+        std::size_t sameNameHash) const;
+
 public:
     OverloadsFinalizer(CorpusImpl& corpus)
         : corpus_(corpus)
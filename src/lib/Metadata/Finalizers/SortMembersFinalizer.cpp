@@ -9,241 +9,199 @@
 //
 
 #include "SortMembersFinalizer.hpp"
+#include <mrdocs/Support/Report.hpp>
+#include <mrdocs/Support/ThreadPool.hpp>
 #include <algorithm>
 #include <ranges>
+#include <span>
+#include <unordered_set>
 
 namespace mrdocs {
 
 namespace {
-// Comparison function by symbol IDs
-struct SymbolIDCompareFn
+bool
+isRelationalOperator(OperatorKind const op)
 {
-    CorpusImpl const& corpus_;
+    return
+        op == OperatorKind::Exclaim ||
+        op == OperatorKind::EqualEqual ||
+        op == OperatorKind::ExclaimEqual ||
+        op == OperatorKind::Less ||
+        op == OperatorKind::Greater ||
+        op == OperatorKind::LessEqual ||
+        op == OperatorKind::GreaterEqual ||
+        op == OperatorKind::Spaceship ||
+        op == OperatorKind::LessLess;
+}
 
-    template <class InfoTy>
-    static
-    Optional<FunctionClass>
-    findFunctionClass(InfoTy const& I)
+bool
+isCopyOrMoveConstOrAssign(
+    FunctionSymbol const& I,
+    SymbolID const& parent)
+{
+    MRDOCS_CHECK_OR(I.Params.size() == 1, false);
+    auto const& param = I.Params[0];
+    Polymorphic<Type> const& paramType = param.Type;
+    MRDOCS_ASSERT(!paramType.valueless_after_move());
+    MRDOCS_CHECK_OR(
+        paramType->isLValueReference() ||
+        paramType->isRValueReference(), false);
+    Polymorphic<Type> const &paramRefPointeeOpt =
+        paramType->isLValueReference()
+            ? paramType->asLValueReference().PointeeType
+            : paramType->asRValueReference().PointeeType;
+    MRDOCS_CHECK_OR(paramRefPointeeOpt, false);
+    auto const& paramRefPointee = *paramRefPointeeOpt;
+    if (!paramRefPointee.isNamed())
     {
-        if constexpr (std::same_as<InfoTy, Symbol>)
-        {
-            return visit(I, []<class U>(U const& u)
-                -> Optional<FunctionClass>
-            {
-                return findFunctionClass<U>(u);
-            });
-        }
-        else if constexpr (
-            std::same_as<FunctionSymbol, InfoTy> ||
-            std::same_as<OverloadsSymbol, InfoTy>)
-        {
-            return I.Class;
-        }
-        return std::nullopt;
+        return false;
     }
+    return paramRefPointee.namedSymbol() == parent;
+}
+
+/*  The sort key of a member
+
+    The key holds everything the comparison needs,
+    so it is computed once per member rather than
+    on each comparison of the sort.
+ */
+struct MemberSortKey
+{
+    SymbolID id;
+
+    // The symbol holding the contents of the member
+    Symbol const* symbol = nullptr;
+
+    // Primary location, when sorting by location
+    Optional<Location> loc;
+
+    OperatorKind op = OperatorKind::None;
+
+    bool isCtor : 1 = false;
+    bool isDtor : 1 = false;
+    bool isAssign : 1 = false;
+    bool isRelational : 1 = false;
+    bool isConversion : 1 = false;
+    bool isCopyOrMove : 1 = false;
+    bool isMove : 1 = false;
+    bool hasOneParam : 1 = false;
+    bool isClassMember : 1 = false;
+};
+
+// Comparison function by member sort keys
+struct MemberSortKeyCompareFn
+{
+    bool ctorsFirst;
+    bool dtorsFirst;
+    bool assignmentFirst;
+    bool relationalLast;
+    bool conversionLast;
+    PublicSettings::SortSymbolBy sortMembersBy;
+    PublicSettings::SortSymbolBy sortNamespaceMembersBy;
 
-    template <class InfoTy>
-    static
-    Optional<OperatorKind>
-    findOperatorKind(InfoTy const& I)
+    explicit
+    MemberSortKeyCompareFn(Config const& config)
+        : ctorsFirst(config->sortMembersCtors1St)
+        , dtorsFirst(config->sortMembersDtors1St)
+        , assignmentFirst(config->sortMembersAssignment1St)
+        , relationalLast(config->sortMembersRelationalLast)
+        , conversionLast(config->sortMembersConversionLast)
+        , sortMembersBy(config->sortMembersBy)
+        , sortNamespaceMembersBy(config->sortNamespaceMembersBy)
     {
-        if constexpr (std::same_as<InfoTy, Symbol>)
-        {
-            return visit(I, []<class U>(U const& u)
-                -> Optional<OperatorKind>
-            {
-                return findOperatorKind<U>(u);
-            });
-        }
-        else if constexpr (
-            std::same_as<FunctionSymbol, InfoTy> ||
-            std::same_as<OverloadsSymbol, InfoTy>)
-        {
-            return I.OverloadedOperator;
-        }
-        return std::nullopt;
     }
 
     bool
-    operator()(SymbolID const& lhsId, SymbolID const& rhsId) const
+    operator()(MemberSortKey const& lhs, MemberSortKey const& rhs) const
     {
-        // Get Info from SymbolID
-        Symbol const* lhsPtr = corpus_.find(lhsId);
-        MRDOCS_CHECK_OR(lhsPtr, false);
-        Symbol const* rhsPtr = corpus_.find(rhsId);
-        MRDOCS_CHECK_OR(rhsPtr, true);
-        Symbol const& lhs = *lhsPtr;
-        Symbol const& rhs = *rhsPtr;
+        // Symbols not in the corpus come last
+        MRDOCS_CHECK_OR(lhs.symbol, false);
+        MRDOCS_CHECK_OR(rhs.symbol, true);
 
         // Constructors come first
-        Optional<FunctionClass> const lhsClass = findFunctionClass(lhs);
-        Optional<FunctionClass> const rhsClass = findFunctionClass(rhs);
-        if (corpus_.config->sortMembersCtors1St)
+        if (ctorsFirst && lhs.isCtor != rhs.isCtor)
         {
-            bool const lhsIsCtor = lhsClass && *lhsClass == FunctionClass::Constructor;
-            bool const rhsIsCtor = rhsClass && *rhsClass == FunctionClass::Constructor;
-            if (lhsIsCtor != rhsIsCtor)
-            {
-                return lhsIsCtor;
-            }
+            return lhs.isCtor;
         }
 
         // Destructors come next
-        if (corpus_.config->sortMembersDtors1St)
+        if (dtorsFirst && lhs.isDtor != rhs.isDtor)
         {
-            bool const lhsIsDtor = lhsClass && *lhsClass == FunctionClass::Destructor;
-            bool const rhsIsDtor = rhsClass && *rhsClass == FunctionClass::Destructor;
-            if (lhsIsDtor != rhsIsDtor)
-            {
-                return lhsIsDtor;
-            }
+            return lhs.isDtor;
         }
 
         // Assignment operators come next
-        Optional<OperatorKind> const lhsOp = findOperatorKind(lhs);
-        Optional<OperatorKind> const rhsOp = findOperatorKind(rhs);
-        if (corpus_.config->sortMembersAssignment1St)
+        if (assignmentFirst && lhs.isAssign != rhs.isAssign)
         {
-            bool const lhsIsAssign = lhsOp && *lhsOp == OperatorKind::Equal;
-            bool const rhsIsAssign = rhsOp && *rhsOp == OperatorKind::Equal;
-            if (lhsIsAssign != rhsIsAssign)
-            {
-                return lhsIsAssign;
-            }
+            return lhs.isAssign;
         }
 
         // Relational operators come last
-        if (corpus_.config->sortMembersRelationalLast)
+        if (relationalLast)
         {
-            bool const lhsIsRel = lhsOp && (
-                *lhsOp == OperatorKind::Exclaim ||
-                *lhsOp == OperatorKind::EqualEqual ||
-                *lhsOp == OperatorKind::ExclaimEqual ||
-                *lhsOp == OperatorKind::Less ||
-                *lhsOp == OperatorKind::Greater ||
-                *lhsOp == OperatorKind::LessEqual ||
-                *lhsOp == OperatorKind::GreaterEqual ||
-                *lhsOp == OperatorKind::Spaceship ||
-                *lhsOp == OperatorKind::LessLess);
-            bool const rhsIsRel = rhsOp && (
-                *rhsOp == OperatorKind::Exclaim ||
-                *rhsOp == OperatorKind::EqualEqual ||
-                *rhsOp == OperatorKind::ExclaimEqual ||
-                *rhsOp == OperatorKind::Less ||
-                *rhsOp == OperatorKind::Greater ||
-                *rhsOp == OperatorKind::LessEqual ||
-                *rhsOp == OperatorKind::GreaterEqual ||
-                *rhsOp == OperatorKind::Spaceship ||
-                *rhsOp == OperatorKind::LessLess);
-            if (lhsIsRel != rhsIsRel)
+            if (lhs.isRelational != rhs.isRelational)
             {
-                return !lhsIsRel;
+                return !lhs.isRelational;
             }
-            if (lhsIsRel && rhsIsRel)
+            if (lhs.isRelational && rhs.isRelational)
             {
-                return std::is_lt(*lhsOp <=> *rhsOp);
+                return std::is_lt(lhs.op <=> rhs.op);
             }
         }
 
         // Conversion operators come last
-        if (corpus_.config->sortMembersConversionLast)
+        if (conversionLast && lhs.isConversion != rhs.isConversion)
         {
-            bool const lhsIsConvertion = lhsClass && *lhsClass == FunctionClass::Conversion;
-            bool const rhsIsConvertion = rhsClass && *rhsClass == FunctionClass::Conversion;
-            if (lhsIsConvertion != rhsIsConvertion)
-            {
-                return !lhsIsConvertion;
-            }
+            return !lhs.isConversion;
         }
 
         // If both are constructors/assignment with 1 parameter, the copy/move
         // constructors come first
-        if ((lhsClass && *lhsClass == FunctionClass::Constructor &&
-            rhsClass && *rhsClass == FunctionClass::Constructor) ||
-            (lhsOp && *lhsOp == OperatorKind::Equal &&
-             rhsOp && *rhsOp == OperatorKind::Equal))
+        if (((lhs.isCtor && rhs.isCtor) ||
+             (lhs.isAssign && rhs.isAssign)) &&
+            lhs.hasOneParam && rhs.hasOneParam)
         {
-            FunctionSymbol const& lhsF = lhs.asFunction();
-            FunctionSymbol const& rhsF = rhs.asFunction();
-            if (lhsF.Params.size() == 1 && rhsF.Params.size() == 1)
+            if (lhs.isCopyOrMove != rhs.isCopyOrMove)
             {
-                auto isCopyOrMoveConstOrAssign = [](FunctionSymbol const& I) {
-                    if (I.Params.size() == 1)
-                    {
-                        auto const& param = I.Params[0];
-                        Polymorphic<Type> const& paramType = param.Type;
-                        MRDOCS_ASSERT(!paramType.valueless_after_move());
-                        MRDOCS_CHECK_OR(
-                            paramType->isLValueReference() ||
-                            paramType->isRValueReference(), false);
-                        Polymorphic<Type> const &paramRefPointeeOpt =
-                            paramType->isLValueReference()
-                                ? paramType->asLValueReference().PointeeType
-                                : paramType->asRValueReference().PointeeType;
-                        MRDOCS_CHECK_OR(paramRefPointeeOpt, false);
-                        auto const& paramRefPointee = *paramRefPointeeOpt;
-                        if (!paramRefPointee.isNamed())
-                        {
-                            return false;
-                        }
-                        return paramRefPointee.namedSymbol() == I.Parent;
-                    }
-                    return false;
-                };
-
-                bool const lhsIsCopyOrMove = isCopyOrMoveConstOrAssign(lhsF);
-                bool const rhsIsCopyOrMove = isCopyOrMoveConstOrAssign(rhsF);
-                if (auto const cmp = lhsIsCopyOrMove <=> rhsIsCopyOrMove;
-                    cmp != 0)
-                {
-                    return !std::is_lt(cmp);
-                }
-                // Ensure move comes after copy
-                if (lhsIsCopyOrMove && rhsIsCopyOrMove)
-                {
-                    MRDOCS_ASSERT(!lhsF.Params[0].Type.valueless_after_move());
-                    MRDOCS_ASSERT(!rhsF.Params[0].Type.valueless_after_move());
-                    bool const lhsIsMove = lhsF.Params[0].Type->isRValueReference();
-                    bool const rhsIsMove = rhsF.Params[0].Type->isRValueReference();
-                    if (lhsIsMove != rhsIsMove)
-                    {
-                        return !lhsIsMove;
-                    }
-                }
+                return lhs.isCopyOrMove;
+            }
+            // Ensure move comes after copy
+            if (lhs.isCopyOrMove &&
+                rhs.isCopyOrMove &&
+                lhs.isMove != rhs.isMove)
+            {
+                return !lhs.isMove;
             }
         }
 
         // Special cases are handled, so use the configuration criteria
-        Symbol const* P = corpus_.find(lhs.Parent);
-        bool const isClassMember = P && P->isRecord();
         auto const generalSortCriteria =
-            isClassMember
-                ? corpus_.config->sortMembersBy
-                : corpus_.config->sortNamespaceMembersBy;
+            lhs.isClassMember
+                ? sortMembersBy
+                : sortNamespaceMembersBy;
         switch (generalSortCriteria)
         {
-        case mrdocs::PublicSettings::SortSymbolBy::Name:
-            if (auto const cmp = lhs.Name <=> rhs.Name; cmp != 0)
+        case PublicSettings::SortSymbolBy::Name:
+            if (auto const cmp = lhs.symbol->Name <=> rhs.symbol->Name;
+                cmp != 0)
             {
                 return std::is_lt(cmp);
             }
             break;
-        case mrdocs::PublicSettings::SortSymbolBy::Location:
+        case PublicSettings::SortSymbolBy::Location:
         {
             // By location: short path, line, column
-            auto const& lhsLoc = getPrimaryLocation(lhs);
-            auto const& rhsLoc = getPrimaryLocation(rhs);
-            if (auto const cmp = lhsLoc->ShortPath <=> rhsLoc->ShortPath;
+            if (auto const cmp = lhs.loc->ShortPath <=> rhs.loc->ShortPath;
                 cmp != 0)
             {
                 return std::is_lt(cmp);
             }
-            if (auto const cmp = lhsLoc->LineNumber <=> rhsLoc->LineNumber;
+            if (auto const cmp = lhs.loc->LineNumber <=> rhs.loc->LineNumber;
                 cmp != 0)
             {
                 return std::is_lt(cmp);
             }
-            if (auto const cmp = lhsLoc->ColumnNumber <=> rhsLoc->ColumnNumber;
+            if (auto const cmp = lhs.loc->ColumnNumber <=> rhs.loc->ColumnNumber;
                 cmp != 0)
             {
                 return std::is_lt(cmp);
@@ -258,17 +216,140 @@ struct SymbolIDCompareFn
         // to ensure a stable sort. For instance, in the case of functions,
         // we sort by name, then number of parameters, then parameter types,
         // and so on.
-        return std::is_lt(CompareDerived(lhs, rhs));
+        if (auto const cmp = CompareDerived(*lhs.symbol, *rhs.symbol);
+            cmp != 0)
+        {
+            return std::is_lt(cmp);
+        }
+        // Inherited members are copies of their
+        // base member, so the id breaks the tie.
+        return lhs.id < rhs.id;
     }
 };
+
+MemberSortKey
+makeSortKey(
+    CorpusImpl const& corpus,
+    SymbolID const& id,
+    bool const needsLocation)
+{
+    MemberSortKey key;
+    key.id = id;
+    key.symbol = corpus.find(id);
+    MRDOCS_CHECK_OR(key.symbol, key);
+    Symbol const& I = *key.symbol;
+
+    Symbol const* P = corpus.find(I.Parent);
+    key.isClassMember = P && P->isRecord();
+    if (needsLocation)
+    {
+        key.loc = getPrimaryLocation(I);
+    }
+
+    Optional<FunctionClass> functionClass;
+    Optional<OperatorKind> op;
+    if (auto const* F = I.asFunctionPtr())
+    {
+        functionClass = F->Class;
+        op = F->OverloadedOperator;
+    }
+    else if (auto const* O = I.asOverloadsPtr())
+    {
+        functionClass = O->Class;
+        op = O->OverloadedOperator;
+    }
+    key.isCtor = functionClass && *functionClass == FunctionClass::Constructor;
+    key.isDtor = functionClass && *functionClass == FunctionClass::Destructor;
+    key.isConversion = functionClass && *functionClass == FunctionClass::Conversion;
+    key.isAssign = op && *op == OperatorKind::Equal;
+    key.isRelational = op && isRelationalOperator(*op);
+    if (key.isRelational)
+    {
+        key.op = *op;
+    }
+
+    if ((key.isCtor || key.isAssign) && I.isFunction())
+    {
+        FunctionSymbol const& F = I.asFunction();
+        key.hasOneParam = F.Params.size() == 1;
+        key.isCopyOrMove = isCopyOrMoveConstOrAssign(F, I.Parent);
+        if (key.isCopyOrMove)
+        {
+            MRDOCS_ASSERT(!F.Params[0].Type.valueless_after_move());
+            key.isMove = F.Params[0].Type->isRValueReference();
+        }
+    }
+    return key;
+}
 } // (anonymous)
 
 void
 SortMembersFinalizer::
 sortMembers(std::vector<SymbolID>& ids)
 {
-    SymbolIDCompareFn const pred{corpus_};
-    std::ranges::sort(ids, pred);
+    // Lists are collected during the traversal and
+    // sorted together once all of them are known
+    MRDOCS_CHECK_OR(ids.size() > 1);
+
+    // Lists can be reached more than once, such as
+    // the nested records of a base class listed by
+    // a derived class, so a list is only queued once
+    // to avoid sorting it in two tasks at a time.
+    MRDOCS_CHECK_OR(queued_.insert(&ids).second);
+    pending_.push_back(&ids);
+}
+
+void
+SortMembersFinalizer::
+sortPending()
+{
+    MemberSortKeyCompareFn const pred(corpus_.config);
+    bool const needsLocation =
+        corpus_.config->sortMembersBy == PublicSettings::SortSymbolBy::Location ||
+        corpus_.config->sortNamespaceMembersBy == PublicSettings::SortSymbolBy::Location;
+    auto sortList = [&](std::vector<SymbolID>& ids)
+    {
+        std::vector<MemberSortKey> keys;
+        keys.reserve(ids.size());
+        for (SymbolID const& id: ids)
+        {
+            keys.push_back(makeSortKey(corpus_, id, needsLocation));
+        }
+        std::ranges::sort(keys, pred);
+        std::ranges::transform(keys, ids.begin(), &MemberSortKey::id);
+    };
+
+    // Member lists are independent, so they are sorted
+    // concurrently. Small lists are grouped together so
+    // that each task has a reasonable amount of work.
+    constexpr std::size_t taskSize = 1024;
+    TaskGroup taskGroup(corpus_.config_->threadPool());
+    auto first = pending_.begin();
+    std::size_t n = 0;
+    for (auto it = pending_.begin(); it != pending_.end();)
+    {
+        n += (*it)->size();
+        ++it;
+        if (n >= taskSize || it == pending_.end())
+        {
+            taskGroup.async(
+                [&sortList, lists = std::span(first, it)]
+                {
+                    for (std::vector<SymbolID>* ids: lists)
+                    {
+                        sortList(*ids);
+                    }
+                });
+            first = it;
+            n = 0;
+        }
+    }
+    for (Error const& err : taskGroup.wait())
+    {
+        report::error("{}", err);
+    }
+    pending_.clear();
+    queued_.clear();
 }
 
 void
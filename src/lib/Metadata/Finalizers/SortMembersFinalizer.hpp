@@ -13,6 +13,7 @@
 
 #include <lib/CorpusImpl.hpp>
 #include <lib/Metadata/SymbolSet.hpp>
+#include <unordered_set>
 
 namespace mrdocs {
 
@@ -28,9 +29,23 @@ class SortMembersFinalizer
 {
     CorpusImpl& corpus_;
 
+    /*  Member lists to be sorted
+
+        The traversal only collects the lists.
+        They are sorted concurrently at the end.
+     */
+    std::vector<std::vector<SymbolID>*> pending_;
+
+    /*  The lists already in pending_
+     */
+    std::unordered_set<std::vector<SymbolID> const*> queued_;
+
     void
     sortMembers(std::vector<SymbolID>& ids);
 
+    void
+    sortPending();
+
     void
     sortMembers(RecordInterface& I);
 
@@ -61,6 +76,7 @@ public:
         MRDOCS_CHECK_OR(globalPtr);
         MRDOCS_ASSERT(globalPtr->isNamespace());
         operator()(globalPtr->asNamespace());
+        sortPending();
     }
 
     void
@@ -38,6 +38,7 @@ merge(OverloadsSymbol& I, OverloadsSymbol&& Other)
         return stdr::find(I.Members, Member) == I.Members.end();
     });
     I.Members.insert(I.Members.end(), newMembers.begin(), newMembers.end());
+    I.MembersHash = hashOverloadMembers(I.Members);
 }
 
 void
@@ -63,6 +64,19 @@ addMember(OverloadsSymbol& I, FunctionSymbol const& Member)
     }
     merge(I.Loc, Member.Loc);
     I.Members.push_back(Member.id);
+    I.MembersHash += std::hash<SymbolID>()(Member.id);
+}
+
+std::size_t
+hashOverloadMembers(std::span<SymbolID const> ids) noexcept
+{
+    // The sum is independent of the order of the members
+    std::size_t h = 0;
+    for (SymbolID const& id: ids)
+    {
+        h += std::hash<SymbolID>()(id);
+    }
+    return h;
 }
 
 } // mrdocs
@@ -0,0 +1,120 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include "CharSet.hpp"
+#include <bit>
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#  define MRDOCS_CHARSET_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define MRDOCS_CHARSET_SSE2
+#endif
+
+namespace mrdocs {
+
+namespace {
+std::size_t
+findFirstOfScalar(
+    std::string_view str,
+    std::size_t pos,
+    CharSet const& set) noexcept
+{
+    for (; pos < str.size(); ++pos)
+    {
+        if (set.contains(str[pos]))
+        {
+            return pos;
+        }
+    }
+    return str.size();
+}
+
+#if defined(MRDOCS_CHARSET_AVX2)
+// Compare blocks of 32 bytes with each character in the set
+std::size_t
+findFirstOfAVX2(
+    std::string_view str,
+    CharSet const& set) noexcept
+{
+    std::string_view const chars = set.chars();
+    __m256i needles[CharSet::capacity];
+    for (std::size_t i = 0; i < chars.size(); ++i)
+    {
+        needles[i] = _mm256_set1_epi8(chars[i]);
+    }
+    std::size_t pos = 0;
+    for (; pos + 32 <= str.size(); pos += 32)
+    {
+        __m256i const block = _mm256_loadu_si256(
+            reinterpret_cast<__m256i const*>(str.data() + pos));
+        __m256i found = _mm256_setzero_si256();
+        for (std::size_t i = 0; i < chars.size(); ++i)
+        {
+            found = _mm256_or_si256(found, _mm256_cmpeq_epi8(block, needles[i]));
+        }
+        if (auto const mask = static_cast<unsigned>(_mm256_movemask_epi8(found)))
+        {
+            return pos + std::countr_zero(mask);
+        }
+    }
+    return findFirstOfScalar(str, pos, set);
+}
+#endif
+
+#if defined(MRDOCS_CHARSET_SSE2)
+// Compare blocks of 16 bytes with each character in the set
+std::size_t
+findFirstOfSSE2(
+    std::string_view str,
+    CharSet const& set) noexcept
+{
+    std::string_view const chars = set.chars();
+    __m128i needles[CharSet::capacity];
+    for (std::size_t i = 0; i < chars.size(); ++i)
+    {
+        needles[i] = _mm_set1_epi8(chars[i]);
+    }
+    std::size_t pos = 0;
+    for (; pos + 16 <= str.size(); pos += 16)
+    {
+        __m128i const block = _mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(str.data() + pos));
+        __m128i found = _mm_setzero_si128();
+        for (std::size_t i = 0; i < chars.size(); ++i)
+        {
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(block, needles[i]));
+        }
+        if (auto const mask = static_cast<unsigned>(_mm_movemask_epi8(found)))
+        {
+            return pos + std::countr_zero(mask);
+        }
+    }
+    return findFirstOfScalar(str, pos, set);
+}
+#endif
+} // (anon)
+
+std::size_t
+findFirstOf(
+    std::string_view str,
+    CharSet const& set) noexcept
+{
+#if defined(MRDOCS_CHARSET_AVX2)
+    return findFirstOfAVX2(str, set);
+#elif defined(MRDOCS_CHARSET_SSE2)
+    return findFirstOfSSE2(str, set);
+#else
+    return findFirstOfScalar(str, 0, set);
+#endif
+}
+
+} // mrdocs
@@ -0,0 +1,98 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#ifndef MRDOCS_LIB_SUPPORT_CHARSET_HPP
+#define MRDOCS_LIB_SUPPORT_CHARSET_HPP
+
+#include <mrdocs/Platform.hpp>
+#include <mrdocs/Support/Assert.hpp>
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace mrdocs {
+
+/** A small set of characters to search for in strings
+
+    Escape functions use the set to find the next
+    character that needs to be replaced, so the
+    characters before it can be written at once.
+*/
+class CharSet
+{
+public:
+    /// The maximum number of characters in a set
+    static constexpr std::size_t capacity = 32;
+
+private:
+    std::array<bool, 256> table_{};
+    std::array<char, capacity> chars_{};
+    std::size_t size_ = 0;
+
+public:
+    /** Constructor
+
+        @param chars The characters in the set
+     */
+    constexpr
+    explicit
+    CharSet(std::string_view chars) noexcept
+    {
+        for (char c : chars)
+        {
+            auto const i = static_cast<unsigned char>(c);
+            if (table_[i])
+            {
+                continue;
+            }
+            MRDOCS_ASSERT(size_ < capacity);
+            table_[i] = true;
+            chars_[size_++] = c;
+        }
+    }
+
+    /** Return true if the set contains a character
+     */
+    constexpr
+    bool
+    contains(char c) const noexcept
+    {
+        return table_[static_cast<unsigned char>(c)];
+    }
+
+    /** Return the characters in the set
+     */
+    constexpr
+    std::string_view
+    chars() const noexcept
+    {
+        return {chars_.data(), size_};
+    }
+};
+
+/** Return the position of the first character of a string in a set
+
+    The string is scanned with SSE2 or AVX2 when
+    the target supports them.
+
+    @param str The string to search
+    @param set The characters to search for
+    @return The position of the first character
+    in the set, or the size of the string if
+    there is none.
+ */
+std::size_t
+findFirstOf(
+    std::string_view str,
+    CharSet const& set) noexcept;
+
+} // mrdocs
+
+#endif // MRDOCS_LIB_SUPPORT_CHARSET_HPP
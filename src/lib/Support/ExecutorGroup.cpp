@@ -10,57 +10,234 @@
 
 #include <mrdocs/Support/Error.hpp>
 #include <mrdocs/Support/ExecutorGroup.hpp>
-#include <mrdocs/Support/unlock_guard.hpp>
+#include <mrdocs/Support/Expected.hpp>
+#include <mrdocs/Support/Report.hpp>
+#include <mrdocs/Support/ScopeExit.hpp>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <optional>
 #include <unordered_set>
 
 
 namespace mrdocs {
 
+namespace {
+
+using Work = any_callable<void(void*)>;
+
+/*  A queue of work
+
+    The owner of a local queue pushes and pops at
+    the back, so recently submitted work, which is
+    likely to touch the same data, runs first.
+    Other agents steal from the front.
+*/
+struct WorkQueue
+{
+    std::mutex mutex;
+    std::deque<Work> work;
+};
+
+/*  Counters of the scheduler
+
+    These are reported when the group is waited
+    on, to help tuning the amount of work per task.
+*/
+struct Stats
+{
+    std::atomic<std::size_t> local = 0;
+    std::atomic<std::size_t> global = 0;
+    std::atomic<std::size_t> stolen = 0;
+    std::atomic<std::size_t> contended = 0;
+};
+
+std::unique_lock<std::mutex>
+lockQueue(WorkQueue& q, Stats& stats)
+{
+    std::unique_lock<std::mutex> lock(q.mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        stats.contended.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+    return lock;
+}
+
+} // (anon)
+
+//------------------------------------------------
+
 struct ExecutorGroupBase::
     Impl
 {
+    struct Slot
+    {
+        Impl* group;
+        std::unique_ptr<AnyAgent> agent;
+        WorkQueue queue;
+    };
+
     ThreadPool& threadPool;
+
+    // Guards the idle slots, the busy
+    // count, and the errors
     std::mutex mutex;
     std::condition_variable cv;
     std::unordered_set<Error> errors;
+    std::vector<Slot*> idle;
     std::size_t busy = 0;
+    std::atomic<std::size_t> numIdle = 0;
+
+    // Work submitted from outside the agents
+    WorkQueue global;
+
+    // Work in any queue which was not started yet
+    std::atomic<std::size_t> pending = 0;
+
+    std::vector<std::unique_ptr<Slot>> slots;
+    Stats stats;
+
+    // The slot running on this thread, if any
+    static thread_local Slot* current;
 
     explicit
     Impl(ThreadPool& threadPool_)
         : threadPool(threadPool_)
     {
     }
-};
 
-class ExecutorGroupBase::
-    scoped_agent
-{
-    ExecutorGroupBase& group_;
-    std::unique_ptr<AnyAgent> agent_;
-
-public:
-    scoped_agent(
-        ExecutorGroupBase& group,
-        std::unique_ptr<AnyAgent> agent) noexcept
-        : group_(group)
-        , agent_(std::move(agent))
+    std::optional<Work>
+    popLocal(Slot& slot)
     {
+        auto lock = lockQueue(slot.queue, stats);
+        MRDOCS_CHECK_OR(!slot.queue.work.empty(), std::nullopt);
+        Work work = std::move(slot.queue.work.back());
+        slot.queue.work.pop_back();
+        stats.local.fetch_add(1, std::memory_order_relaxed);
+        return work;
     }
 
-    ~scoped_agent()
+    std::optional<Work>
+    popGlobal()
     {
-        --group_.impl_->busy;
-        group_.agents_.emplace_back(std::move(agent_));
-        group_.impl_->cv.notify_all();
+        auto lock = lockQueue(global, stats);
+        MRDOCS_CHECK_OR(!global.work.empty(), std::nullopt);
+        Work work = std::move(global.work.front());
+        global.work.pop_front();
+        stats.global.fetch_add(1, std::memory_order_relaxed);
+        return work;
     }
 
-    void* get() const noexcept
+    std::optional<Work>
+    steal(Slot& thief)
     {
-        return agent_->get();
+        std::size_t const n = slots.size();
+        std::size_t start = 0;
+        while (slots[start].get() != &thief)
+        {
+            ++start;
+        }
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            WorkQueue& q = slots[(start + i) % n]->queue;
+            auto lock = lockQueue(q, stats);
+            if (q.work.empty())
+            {
+                continue;
+            }
+            Work work = std::move(q.work.front());
+            q.work.pop_front();
+            stats.stolen.fetch_add(1, std::memory_order_relaxed);
+            return work;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<Work>
+    next(Slot& slot)
+    {
+        MRDOCS_CHECK_OR(pending.load() != 0, std::nullopt);
+        std::optional<Work> work = popLocal(slot);
+        if (!work)
+        {
+            work = popGlobal();
+        }
+        if (!work)
+        {
+            work = steal(slot);
+        }
+        if (work)
+        {
+            pending.fetch_sub(1);
+        }
+        return work;
+    }
+
+    // Start an idle agent, if there is one
+    void
+    wake()
+    {
+        MRDOCS_CHECK_OR_VOID(numIdle.load() != 0);
+        std::unique_lock<std::mutex> lock(mutex);
+        MRDOCS_CHECK_OR_VOID(!idle.empty());
+        Slot* slot = idle.back();
+        idle.pop_back();
+        numIdle.fetch_sub(1);
+        ++busy;
+        lock.unlock();
+        threadPool.async([this, slot] { run(*slot); });
+    }
+
+    void
+    run(Slot& slot)
+    {
+        ScopeExitRestore restore(current, &slot);
+        for (;;)
+        {
+            std::optional<Work> work = next(slot);
+            if (!work)
+            {
+                // Become idle, unless work was submitted
+                // after the queues were checked. The
+                // submitter checks numIdle after making
+                // the work pending, so either it sees this
+                // slot as idle or we see the work.
+                std::lock_guard<std::mutex> lock(mutex);
+                idle.push_back(&slot);
+                numIdle.fetch_add(1);
+                if (pending.load() != 0)
+                {
+                    idle.pop_back();
+                    numIdle.fetch_sub(1);
+                    continue;
+                }
+                --busy;
+                cv.notify_all();
+                return;
+            }
+            try
+            {
+                (*work)(slot.agent->get());
+            }
+            catch(Exception const& ex)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                errors.emplace(ex.error());
+            }
+            catch(std::exception const& ex)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                errors.emplace(Error(ex));
+            }
+        }
     }
 };
 
+thread_local
+ExecutorGroupBase::Impl::Slot*
+ExecutorGroupBase::Impl::current = nullptr;
+
 ExecutorGroupBase::
 AnyAgent::
 ~AnyAgent() = default;
@@ -81,56 +258,32 @@ ExecutorGroupBase(
 
 void
 ExecutorGroupBase::
-post(any_callable<void(void*)> work)
+add(std::unique_ptr<AnyAgent> agent)
 {
-    std::unique_lock<std::mutex> lock(impl_->mutex);
-    work_.emplace_back(std::move(work));
-    if(agents_.empty())
-        return;
-    run(std::move(lock));
+    auto& slot = impl_->slots.emplace_back(
+        std::make_unique<Impl::Slot>());
+    slot->group = impl_.get();
+    slot->agent = std::move(agent);
+    impl_->idle.push_back(slot.get());
+    impl_->numIdle.fetch_add(1);
 }
 
 void
 ExecutorGroupBase::
-run(std::unique_lock<std::mutex> lock)
+post(any_callable<void(void*)> work)
 {
-    std::unique_ptr<AnyAgent> agent(std::move(agents_.back()));
-    agents_.pop_back();
-    ++impl_->busy;
-    lock.unlock();
-
-    impl_->threadPool.async(
-    [this, agent = std::move(agent)]() mutable
+    // Work submitted by an agent of this group goes
+    // to its local queue, and anything else to the
+    // global queue
+    Impl::Slot* slot = Impl::current;
+    WorkQueue& q = slot && slot->group == impl_.get() ?
+        slot->queue : impl_->global;
     {
-        std::unique_lock<std::mutex> lock(impl_->mutex);
-        scoped_agent scope(*this, std::move(agent));
-        for(;;)
-        {
-            if(work_.empty())
-                break;
-            any_callable<void(void*)> work(
-                std::move(work_.front()));
-            work_.pop_front();
-            {
-                lock.unlock();
-                try
-                {
-                    work(scope.get());
-                    lock.lock();
-                }
-                catch(Exception const& ex)
-                {
-                    lock.lock();
-                    impl_->errors.emplace(ex.error());
-                }
-                catch(std::exception const& ex)
-                {
-                    lock.lock();
-                    impl_->errors.emplace(Error(ex));
-                }
-            }
-        }
-    });
+        auto lock = lockQueue(q, impl_->stats);
+        q.work.emplace_back(std::move(work));
+        impl_->pending.fetch_add(1);
+    }
+    impl_->wake();
 }
 
 std::vector<Error>
@@ -141,8 +294,21 @@ wait() noexcept
     impl_->cv.wait(lock,
         [&]
         {
-            return work_.empty() && impl_->busy == 0;
+            return impl_->pending.load() == 0 && impl_->busy == 0;
         });
+
+    Stats& stats = impl_->stats;
+    std::size_t const local = stats.local.exchange(0);
+    std::size_t const global = stats.global.exchange(0);
+    std::size_t const stolen = stats.stolen.exchange(0);
+    std::size_t const contended = stats.contended.exchange(0);
+    if (local + global + stolen != 0)
+    {
+        report::debug(
+            "Executor group ran {} tasks ({} local, {} global, {} stolen) with {} contended locks",
+            local + global + stolen, local, global, stolen, contended);
+    }
+
     std::vector<Error> errors;
     errors.reserve(impl_->errors.size());
     for(auto& err : impl_->errors)
@@ -152,4 +318,3 @@ wait() noexcept
 }
 
 } // mrdocs
-
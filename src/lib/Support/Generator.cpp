@@ -69,6 +69,25 @@ buildOne(
     std::string dir = files::getParentDir(fileName);
     MRDOCS_TRY(files::createDirectory(dir));
 
+    // Leave the file untouched when the output did not change
+    if (corpus.config->skipUnchanged && files::exists(fileName))
+    {
+        std::string contents;
+        MRDOCS_TRY(buildOneString(contents, corpus));
+        if (auto text = files::getFileText(fileName);
+            text && *text == contents)
+        {
+            return {};
+        }
+        std::ofstream os(std::string(fileName),
+            std::ios_base::binary |
+                std::ios_base::out |
+                std::ios_base::trunc);
+        MRDOCS_CHECK(os.is_open(), formatError(R"(std::ofstream("{}") failed)", fileName));
+        os.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        return {};
+    }
+
     std::ofstream os;
     try
     {
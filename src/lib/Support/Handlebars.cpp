@@ -8,6 +8,7 @@
 // Official repository: https://github.com/cppalliance/mrdocs
 //
 
+#include <lib/Support/CharSet.hpp>
 #include <mrdocs/Support/Handlebars.hpp>
 #include <mrdocs/Support/Path.hpp>
 #include <algorithm>
@@ -16,6 +17,7 @@
 #include <chrono>
 #include <filesystem>
 #include <format>
+#include <optional>
 #include <print>
 #include <ranges>
 #include <unordered_set>
@@ -31,15 +33,6 @@ OutputRef&
 OutputRef::
 write_impl( std::string_view sv )
 {
-    // ==========================================
-    // No indent
-    // ==========================================
-    if (indent_ == 0)
-    {
-        fptr_( out_, sv );
-        return *this;
-    }
-
     std::size_t pos = sv.find('\n');
     if (pos == std::string_view::npos)
     {
@@ -70,6 +63,60 @@ write_impl( std::string_view sv )
     return *this;
 }
 
+OutputBuffer::
+OutputBuffer(
+    OutputRef out,
+    std::size_t capacity)
+    : out_(out)
+    , capacity_(capacity)
+{
+    buf_.reserve(capacity_);
+}
+
+OutputBuffer::
+~OutputBuffer()
+{
+    // Errors can't be reported from the destructor.
+    // Callers that need them call flush() first.
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+    }
+}
+
+void
+OutputBuffer::
+append(char const* first, char const* last)
+{
+    auto const n = static_cast<std::size_t>(last - first);
+    if (buf_.size() + n <= capacity_)
+    {
+        buf_.append(first, last);
+        return;
+    }
+    flush();
+    if (n < capacity_)
+    {
+        buf_.append(first, last);
+        return;
+    }
+    out_ << std::string_view(first, n);
+}
+
+void
+OutputBuffer::
+flush()
+{
+    if (!buf_.empty())
+    {
+        out_ << std::string_view(buf_);
+        buf_.clear();
+    }
+}
+
 // ==============================================================
 // Utility functions
 // ==============================================================
@@ -315,8 +362,24 @@ HTMLEscape(
             {'=', "&#x3D;"}
         };
     static constexpr auto badChars = std::views::keys(escapeMap);
-    for (auto c : str)
+    // Newlines are written on their own, as when each
+    // character was written separately, so indentation
+    // is applied to the output in the same way.
+    static constexpr CharSet stopChars("&<>\"'`=\n");
+    while (!str.empty())
     {
+        // Write the characters before the next
+        // special character at once
+        std::size_t const n = findFirstOf(str, stopChars);
+        if (n != 0)
+        {
+            out << str.substr(0, n);
+        }
+        if (n == str.size())
+        {
+            break;
+        }
+        char const c = str[n];
         if (auto it = std::ranges::find(badChars, c); it != badChars.end())
         {
             out << it.base()->second;
@@ -325,6 +388,7 @@ HTMLEscape(
         {
             out << c;
         }
+        str.remove_prefix(n + 1);
     }
 }
 
@@ -353,15 +417,24 @@ escapeExpression(
     }
 }
 
+// Format a value with the escape function of opt, unless noEscape is set
 static void
 format_to(
     OutputRef out,
     dom::Value const& value,
-    HandlebarsOptions const& opt)
+    HandlebarsOptions const& opt,
+    bool noEscape)
 {
     if (value.isString())
     {
-        escapeExpression(out, value.getString(), opt);
+        if (noEscape)
+        {
+            out << value.getString();
+        }
+        else
+        {
+            opt.escapeFunction(out, value.getString());
+        }
     }
     else if (value.isSafeString())
     {
@@ -388,11 +461,11 @@ format_to(
         dom::Array const& array = value.getArray();
         if (!array.empty())
         {
-            format_to(out, array.at(0), opt);
+            format_to(out, array.at(0), opt, noEscape);
             dom::Array::size_type const n = array.size();
             for (std::size_t i = 1; i < n; ++i) {
                 out << ",";
-                format_to(out, array.at(i), opt);
+                format_to(out, array.at(i), opt, noEscape);
             }
         }
         out << "]";
@@ -403,6 +476,15 @@ format_to(
     }
 }
 
+static void
+format_to(
+    OutputRef out,
+    dom::Value const& value,
+    HandlebarsOptions const& opt)
+{
+    format_to(out, value, opt, opt.noEscape);
+}
+
 static constexpr
 std::string_view
 trim_delimiters(std::string_view expression, std::string_view delimiters)
@@ -502,6 +584,18 @@ namespace detail {
          */
         std::string_view templateText;
 
+        /* The compiled template for rootTemplateText.
+
+           When rootTemplateText is the text of a compiled
+           template, tags are looked up in the compiled
+           template instead of parsed again.
+
+           This is null when the text being rendered was
+           not compiled, such as inline partials.
+
+         */
+        CompiledTemplate const* compiled = nullptr;
+
         /* A vector of inline partials view maps.
 
            This vector is used to store maps of inline partials
@@ -1469,6 +1563,216 @@ parseTag(
     return t;
 }
 
+namespace detail {
+    /* The representation of a compiled template
+
+       The compiled template stores the result of scanning
+       the text with findTag and parseTag from the beginning
+       of the text, which is what the renderer would do.
+
+       Because the renderer only ever starts scanning at
+       positions between tags, the same tags can be
+       looked up by position instead of found again.
+     */
+    struct CompiledTemplate
+    {
+        static constexpr std::size_t npos = std::size_t(-1);
+
+        struct Token
+        {
+            // The tag as found by findTag
+            std::string_view str;
+
+            // Offset of the opening braces in the text
+            std::size_t bracePos = 0;
+
+            // Whether the tag is preceded by "\\"
+            bool doubleEscaped = false;
+
+            // The tag parsed without the double escape
+            Handlebars::Tag tag;
+
+            // Index of the first inverse tag of a block
+            // whose contents start at this token
+            std::size_t blockInverse = npos;
+
+            // Index of the closing tag of a block
+            // whose contents start at this token
+            std::size_t blockClose = npos;
+        };
+
+        // The template text all views refer to
+        std::string text;
+
+        // The tags in the order they appear in the text
+        std::vector<Token> tokens;
+
+        // Whether there are no tags after the last token
+        bool complete = false;
+    };
+}
+
+namespace {
+/* Find the tag findTag would find in templateText
+
+   Returns false when the compiled template cannot determine
+   the result for this range of the text, in which case
+   the caller should fall back to findTag.
+
+   Otherwise, tok is set to the tag or to nullptr when
+   findTag would not find a tag.
+ */
+bool
+findCompiledTag(
+    detail::CompiledTemplate::Token const*& tok,
+    detail::CompiledTemplate const& compiled,
+    std::string_view templateText)
+{
+    std::string_view const text = compiled.text;
+    if (templateText.data() < text.data() ||
+        templateText.data() + templateText.size() > text.data() + text.size())
+    {
+        return false;
+    }
+    std::size_t const first = templateText.data() - text.data();
+    std::size_t const last = first + templateText.size();
+
+    auto const& tokens = compiled.tokens;
+    auto it = std::ranges::lower_bound(
+        tokens, first, std::less<>{},
+        &detail::CompiledTemplate::Token::bracePos);
+
+    // The range cannot start inside the previous tag
+    if (it != tokens.begin())
+    {
+        auto const& prev = *std::prev(it);
+        if (prev.str.data() + prev.str.size() > templateText.data())
+        {
+            return false;
+        }
+    }
+
+    // No opening braces in the range
+    if (it == tokens.end())
+    {
+        MRDOCS_CHECK_OR(compiled.complete, false);
+        tok = nullptr;
+        return true;
+    }
+    if (it->bracePos + 2 > last)
+    {
+        tok = nullptr;
+        return true;
+    }
+
+    // The whole tag, including escapes, should be in the range
+    std::size_t const begin = it->str.data() - text.data();
+    std::size_t const end = begin + it->str.size();
+    MRDOCS_CHECK_OR(begin >= first && end <= last, false);
+    tok = &*it;
+    return true;
+}
+} // (anon)
+
+std::string_view
+HandlebarsTemplate::
+text() const noexcept
+{
+    if (!impl_)
+    {
+        return {};
+    }
+    return impl_->text;
+}
+
+HandlebarsTemplate
+Handlebars::
+compile(std::string_view templateText)
+{
+    auto impl = std::make_shared<detail::CompiledTemplate>();
+    impl->text = std::string(templateText);
+    std::string_view const text = impl->text;
+
+    // ==============================================================
+    // Find and parse all tags
+    // ==============================================================
+    auto& tokens = impl->tokens;
+    std::string_view rest = text;
+    std::string_view tagStr;
+    while (findTag(tagStr, rest))
+    {
+        detail::CompiledTemplate::Token tok;
+        tok.str = tagStr;
+        tok.doubleEscaped = tagStr.starts_with("\\\\");
+        std::string_view braces = tagStr;
+        while (braces.starts_with('\\'))
+        {
+            braces.remove_prefix(1);
+        }
+        tok.bracePos = braces.data() - text.data();
+        if (tok.doubleEscaped)
+        {
+            tagStr.remove_prefix(2);
+        }
+        tok.tag = parseTag(tagStr, text);
+        tokens.push_back(tok);
+        rest.remove_prefix(tok.str.data() + tok.str.size() - rest.data());
+    }
+    impl->complete =
+        rest.size() < 4 || rest.find("{{") == std::string_view::npos;
+
+    // ==============================================================
+    // Find the delimiters of each block
+    // ==============================================================
+    // This follows the section levels computed by parseBlock, so
+    // that it can skip from the beginning of the block contents
+    // to its inverse and closing tags.
+    constexpr std::size_t npos = detail::CompiledTemplate::npos;
+    for (std::size_t i = 0; i + 1 < tokens.size(); ++i)
+    {
+        Tag const& opener = tokens[i].tag;
+        bool const opensBlock =
+            !tokens[i].doubleEscaped &&
+            (opener.type == '#' || opener.type == '^' || opener.type2 == '#');
+        if (!opensBlock)
+        {
+            continue;
+        }
+        int l = 1;
+        std::size_t inverse = npos;
+        for (std::size_t k = i + 1; k < tokens.size(); ++k)
+        {
+            // Double escaped tags are always content in parseBlock
+            if (tokens[k].doubleEscaped)
+            {
+                continue;
+            }
+            Tag const& cur = tokens[k].tag;
+            bool const isRegularBlock = cur.type == '#' || cur.type2 == '#';
+            bool const isNestedInvert =
+                cur.type == '^' && cur.type2 == '^' && !cur.content.empty();
+            if (isRegularBlock || isNestedInvert)
+            {
+                ++l;
+            }
+            else if (cur.type == '/' && --l == 0)
+            {
+                tokens[i + 1].blockInverse = inverse;
+                tokens[i + 1].blockClose = k;
+                break;
+            }
+            if (l == 1 && inverse == npos && cur.type == '^')
+            {
+                inverse = k;
+            }
+        }
+    }
+
+    HandlebarsTemplate result;
+    result.impl_ = std::move(impl);
+    return result;
+}
+
 Expected<void, HandlebarsError>
 Handlebars::
 try_render_to(
@@ -1489,6 +1793,27 @@ try_render_to(
     return try_render_to_impl(out, context, options, state);
 }
 
+Expected<void, HandlebarsError>
+Handlebars::
+try_render_to(
+    OutputRef& out,
+    HandlebarsTemplate const& compiled,
+    dom::Value const& context,
+    HandlebarsOptions const& options) const
+{
+    detail::RenderState state;
+    state.rootTemplateText = compiled.text();
+    state.templateText = compiled.text();
+    state.compiled = compiled.impl_.get();
+    if (options.data.isObject()) {
+        state.context = options.data.getObject();
+    }
+    state.inlinePartials.emplace_back();
+    state.rootContext = context;
+    state.contextStack.emplace_back(state.context);
+    return try_render_to_impl(out, context, options, state);
+}
+
 Expected<void, HandlebarsError>
 Handlebars::
 try_render_to_impl(
@@ -1503,17 +1828,30 @@ try_render_to_impl(
         // Find next tag
         // ==============================================================
         std::string_view tagStr;
-        if (!findTag(tagStr, state.templateText))
+        detail::CompiledTemplate::Token const* tok = nullptr;
+        bool const isCompiled =
+            state.compiled &&
+            findCompiledTag(tok, *state.compiled, state.templateText);
+        if (isCompiled ? !tok : !findTag(tagStr, state.templateText))
         {
             out << state.templateText;
             break;
         }
+        if (isCompiled)
+        {
+            tagStr = tok->str;
+        }
         bool const isDoubleEscaped = tagStr.starts_with("\\\\");
         if (isDoubleEscaped) {
             tagStr.remove_prefix(2);
         }
         std::size_t tagStartPos = tagStr.data() - state.templateText.data();
-        Tag tag = parseTag(tagStr, state.rootTemplateText);
+        Tag parsedTag;
+        if (!isCompiled)
+        {
+            parsedTag = parseTag(tagStr, state.rootTemplateText);
+        }
+        Tag const& tag = isCompiled ? tok->tag : parsedTag;
 
         // ==============================================================
         // Render template text before tag
@@ -1700,25 +2038,118 @@ appendContextPath(dom::Value const& contextPath, dom::Value const& id) {
 }
 }
 
+/* The options object passed to helpers
+
+   The data frame, hash, and lookupProperty values
+   are only created when the helper accesses them, so
+   helpers that ignore these values don't pay for them.
+ */
 struct HbsHelperObjectImpl
     : public dom::ObjectImpl
 {
     dom::Value name_;
     dom::Value context_;
-    dom::Value data_;
+    mutable dom::Value data_;
     dom::Value log_;
-    dom::Value hash_;
+    mutable dom::Value hash_;
     dom::Value ids_;
     dom::Value hashIds_;
-    dom::Value lookupProperty_;
+    mutable dom::Value lookupProperty_;
     dom::Value blockParams_;
     dom::Value write_;
     dom::Value fn_;
     dom::Value inverse_;
     dom::Value write_inverse_;
-    dom::Object overlay_;
+    std::optional<dom::Object> overlay_;
+
+    // State the lazy values are created from.
+    // Helpers can keep the options, so the values
+    // are owned rather than referring to the caller.
+    dom::Value dataParent_;
+    dom::Value root_;
+    detail::RenderState const* state_ = nullptr;
+    bool strict_ = false;
+    bool assumeObjects_ = false;
+
+    // Whether the root context is also the "root"
+    // property, as in the options of subexpressions
+    bool hasRoot_ = false;
+
+    enum LazyValue : unsigned char
+    {
+        LazyData = 1,
+        LazyHash = 2,
+        LazyLookupProperty = 4,
+        LazyAll = 7
+    };
+
+    // The lazy values not created yet
+    mutable unsigned char pending_ = 0;
+
+    void
+    materialize(unsigned char values) const
+    {
+        unsigned char const todo = pending_ & values;
+        if (!todo)
+        {
+            return;
+        }
+        pending_ &= ~todo;
+        if (todo & LazyData)
+        {
+            dom::Object data = dataParent_.isObject() ?
+                createFrame(dataParent_.getObject()) :
+                dom::Object{};
+            data.set("root", root_);
+            data_ = data;
+        }
+        if (todo & LazyHash)
+        {
+            hash_ = dom::newObject<dom::DefaultObjectImpl>();
+        }
+        if (todo & LazyLookupProperty)
+        {
+            HandlebarsOptions opt;
+            opt.strict = strict_;
+            opt.assumeObjects = assumeObjects_;
+            lookupProperty_ = dom::makeInvocable([state = state_, opt = std::move(opt)](
+                dom::Value const& obj, dom::Value const& field) -> dom::Value
+            {
+                return lookupPropertyImpl(obj, field, *state, opt).value().first;
+            });
+        }
+    }
 
 public:
+    /* Construct the options for a helper call
+
+       Only the lookupProperty function refers to
+       the render state, so it should not be called
+       once the template is rendered.
+     */
+    HbsHelperObjectImpl(
+        std::string_view name,
+        dom::Value const& context,
+        detail::RenderState const& state,
+        HandlebarsOptions const& opt,
+        dom::Function const& log,
+        bool hasRoot = false)
+        : name_(name)
+        , context_(context)
+        , log_(log)
+        , root_(state.rootContext)
+        , state_(&state)
+        , strict_(opt.strict)
+        , assumeObjects_(opt.assumeObjects)
+        , hasRoot_(hasRoot)
+        , pending_(LazyAll)
+    {
+        if (!state.context.empty())
+        {
+            dataParent_ = state.context;
+        }
+    }
+
     ~HbsHelperObjectImpl() override = default;
 
     char const*
@@ -1729,47 +2160,60 @@ public:
 
     std::size_t size() const override
     {
-        return 13 + overlay_.size();
+        return 13 + hasRoot_ + (overlay_ ? overlay_->size() : 0);
     }
 
     dom::Value get(std::string_view key) const override
     {
         if (key == "name") return name_;
         if (key == "context") return context_;
-        if (key == "data") return data_;
+        if (key == "data") { materialize(LazyData); return data_; }
         if (key == "log") return log_;
-        if (key == "hash") return hash_;
+        if (key == "hash") { materialize(LazyHash); return hash_; }
         if (key == "ids") return ids_;
         if (key == "hashIds") return hashIds_;
-        if (key == "lookupProperty") return lookupProperty_;
+        if (key == "lookupProperty") { materialize(LazyLookupProperty); return lookupProperty_; }
         if (key == "blockParams") return blockParams_;
         if (key == "write") return write_;
         if (key == "fn") return fn_;
         if (key == "inverse") return inverse_;
         if (key == "write_inverse") return write_inverse_;
-        return overlay_.get(key);
+        if (hasRoot_ && key == "root") return root_;
+        return overlay_ ? overlay_->get(key) : dom::Value{};
     }
 
     void set(dom::String key, dom::Value value) override
     {
         if (key == "name") { name_ = value; return; }
         if (key == "context") { context_ = value; return; }
-        if (key == "data") { data_ = value; return; }
+        if (key == "data") { pending_ &= ~LazyData; data_ = value; return; }
         if (key == "log") { log_ = value; return; }
-        if (key == "hash") { hash_ = value; return; }
+        if (key == "hash") { pending_ &= ~LazyHash; hash_ = value; return; }
         if (key == "ids") { ids_ = value; return; }
         if (key == "hashIds") { hashIds_ = value; return; }
-        if (key == "lookupProperty") { lookupProperty_ = value; return; }
+        if (key == "lookupProperty") { pending_ &= ~LazyLookupProperty; lookupProperty_ = value; return; }
         if (key == "blockParams") { blockParams_ = value; return; }
         if (key == "write") { write_ = value; return; }
         if (key == "fn") { fn_ = value; return; }
         if (key == "inverse") { inverse_ = value; return; }
         if (key == "write_inverse") { write_inverse_ = value; return; }
-        overlay_.set(key, value);
+        if (hasRoot_ && key == "root")
+        {
+            // The data frame keeps the original root
+            materialize(LazyData);
+            root_ = value;
+            return;
+        }
+        if (!overlay_)
+        {
+            overlay_.emplace();
+        }
+        overlay_->set(key, value);
     }
 
     bool visit(std::function<bool(dom::String, dom::Value)> visitor) const override
     {
+        materialize(LazyAll);
         if (!visitor("name", name_)) return false;
         if (!visitor("context", context_)) return false;
         if (!visitor("data", data_)) return false;
@@ -1783,7 +2227,8 @@ public:
         if (!visitor("fn", fn_)) return false;
         if (!visitor("inverse", inverse_)) return false;
         if (!visitor("write_inverse", write_inverse_)) return false;
-        return overlay_.visit(visitor);
+        if (hasRoot_ && !visitor("root", root_)) return false;
+        return !overlay_ || overlay_->visit(visitor);
     }
 
     bool exists(std::string_view key) const override
@@ -1801,10 +2246,31 @@ public:
         if (key == "fn") return true;
         if (key == "inverse") return true;
         if (key == "write_inverse") return true;
-        return overlay_.exists(key);
+        if (hasRoot_ && key == "root") return true;
+        return overlay_ && overlay_->exists(key);
     }
 };
 
+/* Return the options with strict mode disabled
+
+   The options are only copied when they are strict,
+   which is not the default.
+ */
+static
+HandlebarsOptions const&
+disableStrict(
+    HandlebarsOptions const& opt,
+    std::optional<HandlebarsOptions>& copy)
+{
+    if (!opt.strict)
+    {
+        return opt;
+    }
+    copy.emplace(opt);
+    copy->strict = false;
+    return *copy;
+}
+
 Expected<Handlebars::evalExprResult, HandlebarsError>
 Handlebars::
 evalExpr(
@@ -1879,18 +2345,8 @@ evalExpr(
             }
             all.remove_prefix(helper.data() + helper.size() - all.data());
             dom::Array args = dom::newArray<dom::DefaultArrayImpl>();
-            dom::Object cb = dom::newObject<HbsHelperObjectImpl>();
-            cb.set("name", helper);
-            cb.set("context", context);
-            dom::Object data;
-            if (!state.context.empty())
-            {
-                data = createFrame(state.context);
-            }
-            data.set("root", state.rootContext);
-            cb.set("data", data);
-            cb.set("root", state.rootContext);
-            cb.set("log", logger_);
+            dom::Object cb = dom::newObject<HbsHelperObjectImpl>(
+                helper, context, state, opt, logger_, true);
             setupArgs(all, context, state, args, cb, opt);
             return Res{fn.call(args).value(), true, false, true};
             MRDOCS_UNREACHABLE();
@@ -2106,7 +2562,7 @@ Handlebars::
 getPartial(
     std::string_view name,
     detail::RenderState const& state) const
-    -> std::pair<std::string_view, bool>
+    -> getPartialResult
 {
     // Inline partials
     auto blockPartials = std::ranges::views::reverse(state.inlinePartials);
@@ -2115,7 +2571,7 @@ getPartial(
         auto it = blockInlinePartials.find(name);
         if (it != blockInlinePartials.end())
         {
-            return {it->second, true};
+            return {it->second, nullptr, true};
         }
     }
 
@@ -2123,7 +2579,7 @@ getPartial(
     auto it = this->partials_.find(name);
     if (it != this->partials_.end())
     {
-        return {it->second, true};
+        return {it->second.text(), it->second.impl_.get(), true};
     }
 
     // Partial block
@@ -2132,10 +2588,11 @@ getPartial(
     {
         return {
             state.partialBlocks[state.partialBlockLevel - 1],
+            nullptr,
             true};
     }
 
-    return { {}, false };
+    return {};
 }
 
 // Parse a block starting at templateText
@@ -2177,18 +2634,71 @@ parseBlock(
     int l = 1;
     std::string_view* curBlock = &fnBlock;
     bool closed = false;
+
+    // ==============================================================
+    // Find the block delimiters in compiled templates
+    // ==============================================================
+    // The tags between the delimiters only change the section
+    // level, so only the inverse and closing tags are visited.
+    using Token = detail::CompiledTemplate::Token;
+    std::array<Token const*, 2> delimiters{};
+    std::size_t nDelimiters = 0;
+    std::size_t nextDelimiter = 0;
+    Token const* tok = nullptr;
+    if (!tag.rawBlock &&
+        state.compiled &&
+        findCompiledTag(tok, *state.compiled, templateText) &&
+        tok &&
+        tok->blockClose != detail::CompiledTemplate::npos)
+    {
+        auto const& tokens = state.compiled->tokens;
+        Token const& close = tokens[tok->blockClose];
+        if (close.str.data() + close.str.size() <=
+            templateText.data() + templateText.size())
+        {
+            if (tok->blockInverse != detail::CompiledTemplate::npos)
+            {
+                delimiters[nDelimiters++] = &tokens[tok->blockInverse];
+            }
+            delimiters[nDelimiters++] = &close;
+        }
+    }
+
     while (!templateText.empty())
     {
         // ==============================================================
         // Find next tag
         // ==============================================================
-        std::string_view tagStr;
-        if (!findTag(tagStr, templateText))
+        Handlebars::Tag curTag;
+        if (nDelimiters != 0)
         {
-            break;
+            if (nextDelimiter == nDelimiters)
+            {
+                break;
+            }
+            curTag = delimiters[nextDelimiter++]->tag;
+        }
+        else if (
+            state.compiled &&
+            findCompiledTag(tok, *state.compiled, templateText))
+        {
+            if (!tok)
+            {
+                break;
+            }
+            curTag = tok->doubleEscaped ?
+                parseTag(tok->str, state.rootTemplateText) :
+                tok->tag;
+        }
+        else
+        {
+            std::string_view tagStr;
+            if (!findTag(tagStr, templateText))
+            {
+                break;
+            }
+            curTag = parseTag(tagStr, state.rootTemplateText);
         }
-
-        Handlebars::Tag curTag = parseTag(tagStr, state.rootTemplateText);
 
         // move template after the tag
         auto tag_pos = curTag.buffer.data() - templateText.data();
@@ -2399,8 +2909,7 @@ renderExpression(
         return {};
     }
 
-    auto opt2 = opt;
-    opt2.noEscape = tag.forceNoEscape || opt.noEscape;
+    bool const noEscape = tag.forceNoEscape || opt.noEscape;
 
     // ==============================================================
     // Helpers as block params
@@ -2408,7 +2917,7 @@ renderExpression(
     if (state.blockValues.exists(tag.helper))
     {
         auto v = state.blockValues.get(tag.helper);
-        format_to(out, v, opt2);
+        format_to(out, v, opt, noEscape);
         if (tag.removeRWhitespace) {
             state.templateText = trim_lspaces(state.templateText);
         }
@@ -2420,26 +2929,16 @@ renderExpression(
     // ==============================================================
     auto it = helpers_.find(tag.helper);
     if (it != helpers_.end()) {
-        auto fn = it->second;
+        dom::Function const& fn = it->second;
+        std::optional<HandlebarsOptions> noStrictCopy;
+        HandlebarsOptions const& noStrict = disableStrict(opt, noStrictCopy);
         dom::Array args = dom::newArray<dom::DefaultArrayImpl>();
-        dom::Object cb = dom::newObject<HbsHelperObjectImpl>();
-        cb.set("name", tag.helper);
-        cb.set("context", context);
-        dom::Object data;
-        if (!state.context.empty())
-        {
-            data = createFrame(state.context);
-        }
-        data.set("root", state.rootContext);
-        cb.set("data", data);
-        cb.set("log", logger_);
-        HandlebarsOptions noStrict = opt;
-        noStrict.strict = false;
+        dom::Object cb = dom::newObject<HbsHelperObjectImpl>(
+            tag.helper, context, state, noStrict, logger_);
         MRDOCS_TRY(setupArgs(tag.arguments, context, state, args, cb, noStrict));
         dom::Value res = fn.call(args).value();
         if (!res.isUndefined()) {
-            opt2.noEscape = opt2.noEscape || res.isSafeString();
-            format_to(out, res, opt2);
+            format_to(out, res, opt, noEscape || res.isSafeString());
         }
         if (tag.removeRWhitespace) {
             state.templateText = trim_lspaces(state.templateText);
@@ -2462,20 +2961,11 @@ renderExpression(
     {
         if (resV.value.isFunction())
         {
+            std::optional<HandlebarsOptions> noStrictCopy;
+            HandlebarsOptions const& noStrict = disableStrict(opt, noStrictCopy);
             dom::Array args = dom::newArray<dom::DefaultArrayImpl>();
-            dom::Object cb = dom::newObject<HbsHelperObjectImpl>();
-            cb.set("name", helper_expr);
-            cb.set("context", context);
-            dom::Object data;
-            if (!state.context.empty())
-            {
-                data = createFrame(state.context);
-            }
-            data.set("root", state.rootContext);
-            cb.set("data", data);
-            cb.set("log", logger_);
-            HandlebarsOptions noStrict = opt;
-            noStrict.strict = false;
+            dom::Object cb = dom::newObject<HbsHelperObjectImpl>(
+                helper_expr, context, state, noStrict, logger_);
             setupArgs(tag.arguments, context, state, args, cb, noStrict);
             Expected<dom::Value> expV2 = resV.value.getFunction().call(args);
             if (!expV2) {
@@ -2488,11 +2978,11 @@ renderExpression(
                 return Unexpected(HandlebarsError(msg));
             }
             dom::Value v2 = *std::move(expV2);
-            format_to(out, v2, opt2);
+            format_to(out, v2, opt, noEscape);
         }
         else
         {
-            format_to(out, resV.value, opt2);
+            format_to(out, resV.value, opt, noEscape);
         }
         return {};
     }
@@ -2507,20 +2997,11 @@ renderExpression(
     // helperMissing hook
     // ==============================================================
     auto [fn, found] = getHelper(helper_expr, false);
+    std::optional<HandlebarsOptions> noStrictCopy;
+    HandlebarsOptions const& noStrict = disableStrict(opt, noStrictCopy);
     dom::Array args = dom::newArray<dom::DefaultArrayImpl>();
-    dom::Object cb = dom::newObject<HbsHelperObjectImpl>();
-    cb.set("name", helper_expr);
-    cb.set("context", context);
-    dom::Object data;
-    if (!state.context.empty())
-    {
-        data = createFrame(state.context);
-    }
-    data.set("root", state.rootContext);
-    cb.set("data", data);
-    cb.set("log", logger_);
-    HandlebarsOptions noStrict = opt;
-    noStrict.strict = false;
+    dom::Object cb = dom::newObject<HbsHelperObjectImpl>(
+        helper_expr, context, state, noStrict, logger_);
     setupArgs(tag.arguments, context, state, args, cb, noStrict);
     Expected<dom::Value> exp2 = fn.call(args);
     if (!exp2)
@@ -2537,8 +3018,7 @@ renderExpression(
     dom::Value res = *exp2;
     if (!res.isUndefined())
     {
-        opt2.noEscape = opt2.noEscape || res.isSafeString();
-        format_to(out, res, opt2);
+        format_to(out, res, opt, noEscape || res.isSafeString());
     }
     if (tag.removeRWhitespace)
     {
@@ -2582,18 +3062,14 @@ setupArgs(
     // ==========================================
     // Initial setup
     // ==========================================
-    cb.set("hash", dom::newObject<dom::DefaultObjectImpl>());
+    // The hash and lookupProperty values of the
+    // helper options are created on demand.
     if (opt.trackIds)
     {
         cb.set("ids", dom::newArray<dom::DefaultArrayImpl>());
         cb.set("hashIds", dom::newObject<dom::DefaultObjectImpl>());
     }
-    else
-    {
-        cb.set("ids", {});
-        cb.set("hashIds", {});
-    }
-    dom::Object hash = cb.get("hash").getObject();
+    dom::Value hash;
     while (findExpr(expr, expression))
     {
         // ==========================================
@@ -2665,7 +3141,11 @@ setupArgs(
             // Named argument
             // ==========================================
             MRDOCS_TRY(auto res, evalExpr(context, v, state, opt, true));
-            hash.set(k, res.value);
+            if (hash.isUndefined())
+            {
+                hash = cb.get("hash");
+            }
+            hash.getObject().set(k, res.value);
             if (opt.trackIds) {
                 dom::Object hashIds = cb.get("hashIds").getObject();
                 if (res.isLiteral) {
@@ -2680,11 +3160,6 @@ setupArgs(
             }
         }
     }
-    cb.set("lookupProperty", dom::makeInvocable([&state, &opt](
-        dom::Value const& obj, dom::Value const& field) -> dom::Value
-    {
-        return lookupPropertyImpl(obj, field, state, opt).value().first;
-    }));
     args.emplace_back(cb);
     return {};
 }
@@ -2792,7 +3267,7 @@ renderPartial(
     // ==============================================================
     // Find registered partial content
     // ==============================================================
-    auto [partial_content, found] = getPartial(partialName, state);
+    auto [partial_content, partial_compiled, found] = getPartial(partialName, state);
     if (!found)
     {
         if (tag.type2 == '#')
@@ -2853,6 +3328,7 @@ renderPartial(
     // Populate with arguments
     // ==========================================
     bool partialCtxChanged = false;
+    bool hasHashArguments = false;
     dom::Value prevContextPath = state.context.get("contextPath");
     if (!tag.arguments.empty())
     {
@@ -2917,6 +3393,7 @@ renderPartial(
             // ==========================================
             // Add named argument to context
             // ==========================================
+            hasHashArguments = true;
             evalExprResult res;
             if (contextKey != ".")
             {
@@ -2962,6 +3439,8 @@ renderPartial(
     // ==========================================
     std::string_view rootTemplateText = state.rootTemplateText;
     state.rootTemplateText = partial_content;
+    detail::CompiledTemplate const* compiled = state.compiled;
+    state.compiled = partial_compiled;
     std::string_view templateText = state.templateText;
     state.templateText = partial_content;
     bool const isPartialBlock = partialName == "@partial-block";
@@ -2976,7 +3455,35 @@ renderPartial(
     // ==========================================
     // Render partial
     // ==========================================
-    MRDOCS_TRY(this->try_render_to_impl(out, partialCtx, opt, state));
+    // Only registered partials rendered without
+    // indentation are cached, so the fragment is
+    // the same for all calls with the same key
+    std::string cacheKey;
+    if (fragmentCache_ &&
+        partial_compiled &&
+        tag.type2 != '#' &&
+        !isPartialBlock &&
+        !hasHashArguments &&
+        out.getIndent() == 0)
+    {
+        cacheKey = fragmentCache_->key(partialName, partialCtx, state.rootContext);
+    }
+    if (cacheKey.empty())
+    {
+        MRDOCS_TRY(this->try_render_to_impl(out, partialCtx, opt, state));
+    }
+    else if (auto fragment = fragmentCache_->find(cacheKey))
+    {
+        out << *fragment;
+    }
+    else
+    {
+        std::string rendered;
+        OutputRef renderedOut(rendered);
+        MRDOCS_TRY(this->try_render_to_impl(renderedOut, partialCtx, opt, state));
+        out << rendered;
+        fragmentCache_->insert(std::move(cacheKey), std::move(rendered));
+    }
 
     // ==========================================
     // Restore state
@@ -2990,6 +3497,7 @@ renderPartial(
     state.partialBlockLevel += isPartialBlock;
     state.templateText = templateText;
     state.rootTemplateText = rootTemplateText;
+    state.compiled = compiled;
     if (opt.trackIds && partialCtxChanged)
     {
         state.context.set("contextPath", prevContextPath);
@@ -3099,20 +3607,12 @@ renderBlock(
     // ==============================================================
     // Setup helper context
     // ==============================================================
+    std::optional<HandlebarsOptions> noStrictCopy;
+    HandlebarsOptions const& noStrict =
+        emulateMustache ? opt : disableStrict(opt, noStrictCopy);
     dom::Array args = dom::newArray<dom::DefaultArrayImpl>();
-    dom::Object cb = dom::newObject<HbsHelperObjectImpl>();
-    cb.set("name", tag.helper);
-    cb.set("context", context);
-    dom::Object data;
-    if (!state.context.empty())
-    {
-        data = createFrame(state.context);
-    }
-    data.set("root", state.rootContext);
-    cb.set("data", data);
-    cb.set("log", logger_);
-    HandlebarsOptions noStrict = opt;
-    noStrict.strict = opt.strict && emulateMustache;
+    dom::Object cb = dom::newObject<HbsHelperObjectImpl>(
+        tag.helper, context, state, noStrict, logger_);
     setupArgs(tagArgumentsStr, context, state, args, cb, noStrict);
 
     // ==========================================
@@ -3473,9 +3973,7 @@ renderBlock(
     dom::Value res = *exp2;
     if (!res.isUndefined()) {
         // Block helpers are always unescaped
-        HandlebarsOptions opt2 = opt;
-        opt2.noEscape = true;
-        format_to(out, res, opt2);
+        format_to(out, res, opt, true);
     }
     state.inlinePartials.pop_back();
     // state.parentContext.pop_back();
@@ -3488,11 +3986,20 @@ Handlebars::
 registerPartial(
     std::string_view name,
     std::string_view text)
+{
+    registerPartial(name, compile(text));
+}
+
+void
+Handlebars::
+registerPartial(
+    std::string_view name,
+    HandlebarsTemplate compiled)
 {
     auto it = partials_.find(name);
     if (it != partials_.end())
         partials_.erase(it);
-    partials_.emplace(std::string(name), std::string(text));
+    partials_.emplace(std::string(name), std::move(compiled));
 }
 
 void
@@ -3513,6 +4020,13 @@ registerLogger(dom::Function fn)
     logger_ = std::move(fn);
 }
 
+void
+Handlebars::
+setFragmentCache(std::shared_ptr<HandlebarsFragmentCache> cache)
+{
+    fragmentCache_ = std::move(cache);
+}
+
 namespace helpers {
 
 Expected<void>
@@ -6959,6 +7473,13 @@ registerTypeHelpers(Handlebars& hbs)
 
 } // helpers
 
+bool
+Handlebars::
+hasHelper(std::string_view name) const
+{
+    return helpers_.find(name) != helpers_.end();
+}
+
 void
 Handlebars::
 unregisterHelper(std::string_view name) {
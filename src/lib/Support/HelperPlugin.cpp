@@ -0,0 +1,257 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include "HelperPlugin.hpp"
+#include <llvm/Support/DynamicLibrary.h>
+#include <format>
+
+// The opaque value type of the C interface
+struct mrdocs_value
+{
+    mrdocs::dom::Value value;
+};
+
+namespace mrdocs {
+
+namespace {
+// kind_impl converts dom::Kind directly, so
+// every value of the C enum must match
+constexpr
+bool
+matches(dom::Kind kind, mrdocs_value_kind value) noexcept
+{
+    return static_cast<int>(kind) == static_cast<int>(value);
+}
+
+static_assert(
+    matches(dom::Kind::Undefined, MRDOCS_VALUE_UNDEFINED) &&
+    matches(dom::Kind::Null, MRDOCS_VALUE_NULL) &&
+    matches(dom::Kind::Boolean, MRDOCS_VALUE_BOOLEAN) &&
+    matches(dom::Kind::Integer, MRDOCS_VALUE_INTEGER) &&
+    matches(dom::Kind::String, MRDOCS_VALUE_STRING) &&
+    matches(dom::Kind::SafeString, MRDOCS_VALUE_SAFE_STRING) &&
+    matches(dom::Kind::Array, MRDOCS_VALUE_ARRAY) &&
+    matches(dom::Kind::Object, MRDOCS_VALUE_OBJECT) &&
+    matches(dom::Kind::Function, MRDOCS_VALUE_FUNCTION),
+    "mrdocs_value_kind should match dom::Kind");
+
+mrdocs_value_kind
+kind_impl(mrdocs_value const* v)
+{
+    return static_cast<mrdocs_value_kind>(v->value.kind());
+}
+
+int
+is_truthy_impl(mrdocs_value const* v)
+{
+    return v->value.isTruthy();
+}
+
+int64_t
+get_integer_impl(mrdocs_value const* v)
+{
+    return v->value.isInteger() ? v->value.getInteger() : 0;
+}
+
+char const*
+get_string_impl(mrdocs_value const* v, size_t* size)
+{
+    if (!v->value.isString() && !v->value.isSafeString())
+    {
+        *size = 0;
+        return nullptr;
+    }
+    std::string_view const str = v->value.getString().get();
+    *size = str.size();
+    return str.data();
+}
+
+size_t
+size_impl(mrdocs_value const* v)
+{
+    if (!v->value.isArray() && !v->value.isObject())
+    {
+        return 0;
+    }
+    return v->value.size();
+}
+
+void
+get_property_impl(
+    mrdocs_value const* v,
+    char const* key,
+    size_t key_size,
+    mrdocs_value* out)
+{
+    out->value = v->value.isObject() ?
+        v->value.get(std::string_view(key, key_size)) :
+        dom::Value{};
+}
+
+void
+get_element_impl(
+    mrdocs_value const* v,
+    size_t i,
+    mrdocs_value* out)
+{
+    out->value = v->value.isArray() ?
+        v->value.get(i) :
+        dom::Value{};
+}
+
+mrdocs_value*
+create_impl()
+{
+    return new mrdocs_value{};
+}
+
+void
+destroy_impl(mrdocs_value* v)
+{
+    delete v;
+}
+
+void
+copy_impl(mrdocs_value* dst, mrdocs_value const* src)
+{
+    dst->value = src->value;
+}
+
+void
+set_null_impl(mrdocs_value* v)
+{
+    v->value = nullptr;
+}
+
+void
+set_boolean_impl(mrdocs_value* v, int b)
+{
+    v->value = dom::Value(b != 0);
+}
+
+void
+set_integer_impl(mrdocs_value* v, int64_t i)
+{
+    v->value = static_cast<std::int64_t>(i);
+}
+
+void
+set_string_impl(mrdocs_value* v, char const* s, size_t size)
+{
+    v->value = std::string_view(s, size);
+}
+
+void
+set_safe_string_impl(mrdocs_value* v, char const* s, size_t size)
+{
+    v->value = safeString(std::string_view(s, size));
+}
+
+constexpr mrdocs_helper_api helperApi = {
+    MRDOCS_HELPER_PLUGIN_VERSION,
+    &kind_impl,
+    &is_truthy_impl,
+    &get_integer_impl,
+    &get_string_impl,
+    &size_impl,
+    &get_property_impl,
+    &get_element_impl,
+    &create_impl,
+    &destroy_impl,
+    &copy_impl,
+    &set_null_impl,
+    &set_boolean_impl,
+    &set_integer_impl,
+    &set_string_impl,
+    &set_safe_string_impl
+};
+
+void
+registerNativeHelper(
+    void* registry,
+    char const* name,
+    mrdocs_helper_fn fn)
+{
+    if (!name || !fn)
+    {
+        return;
+    }
+    auto& helpers = *static_cast<std::vector<NativeHelper>*>(registry);
+    helpers.push_back({name, fn});
+}
+} // (anon)
+
+bool
+isHelperPlugin(std::string_view path) noexcept
+{
+#if defined(_WIN32)
+    return path.ends_with(".dll");
+#elif defined(__APPLE__)
+    return path.ends_with(".dylib");
+#else
+    return path.ends_with(".so");
+#endif
+}
+
+Expected<std::vector<NativeHelper>>
+loadHelperPlugin(std::string const& path)
+{
+    std::string err;
+    llvm::sys::DynamicLibrary lib =
+        llvm::sys::DynamicLibrary::getPermanentLibrary(path.c_str(), &err);
+    MRDOCS_CHECK(lib.isValid(),
+        formatError("Failed to load helper plugin \"{}\": {}", path, err));
+    void* entry = lib.getAddressOfSymbol(MRDOCS_HELPER_PLUGIN_ENTRY);
+    MRDOCS_CHECK(entry,
+        formatError("Helper plugin \"{}\" does not export {}",
+            path, MRDOCS_HELPER_PLUGIN_ENTRY));
+    auto const registerHelpers =
+        reinterpret_cast<mrdocs_register_helpers_fn>(entry);
+    std::vector<NativeHelper> helpers;
+    int const res = registerHelpers(
+        MRDOCS_HELPER_PLUGIN_VERSION,
+        &helpers,
+        &registerNativeHelper);
+    MRDOCS_CHECK(res == 0,
+        formatError("Helper plugin \"{}\" failed to register its helpers: {}",
+            path, res));
+    return helpers;
+}
+
+dom::Function
+makeNativeHelper(NativeHelper const& helper)
+{
+    return dom::makeVariadicInvocable(
+        [fn = helper.fn, name = helper.name](dom::Array const& args)
+            -> Expected<dom::Value>
+    {
+        std::size_t const n = args.size();
+        std::vector<mrdocs_value> values;
+        values.reserve(n);
+        std::vector<mrdocs_value const*> ptrs;
+        ptrs.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            values.push_back({args.get(i)});
+            ptrs.push_back(&values.back());
+        }
+        mrdocs_value result;
+        if (fn(&helperApi, ptrs.data(), n, &result) != 0)
+        {
+            std::string_view msg = result.value.isString() ?
+                result.value.getString().get() :
+                std::string_view("unknown error");
+            return Unexpected(formatError("{}: {}", name, msg));
+        }
+        return std::move(result.value);
+    });
+}
+
+} // mrdocs
@@ -0,0 +1,60 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#ifndef MRDOCS_LIB_SUPPORT_HELPERPLUGIN_HPP
+#define MRDOCS_LIB_SUPPORT_HELPERPLUGIN_HPP
+
+#include <mrdocs/Dom.hpp>
+#include <mrdocs/Support/Error.hpp>
+#include <mrdocs/Support/HelperPlugin.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mrdocs {
+
+/** A helper exported by a native plugin
+ */
+struct NativeHelper
+{
+    std::string name;
+    mrdocs_helper_fn fn = nullptr;
+};
+
+/** Determine if a file is a native helper plugin
+
+    @param path The path of the file
+    @return `true` if the file has the extension of
+    shared libraries on this platform.
+ */
+bool
+isHelperPlugin(std::string_view path) noexcept;
+
+/** Load the helpers exported by a native plugin
+
+    The library is loaded once and remains loaded
+    until the program exits, so the functions can
+    be registered in any number of environments.
+
+    @param path The path of the shared library
+    @return The helpers exported by the plugin,
+    or an error if the library could not be loaded.
+ */
+Expected<std::vector<NativeHelper>>
+loadHelperPlugin(std::string const& path);
+
+/** Return a function that calls a native helper
+ */
+dom::Function
+makeNativeHelper(NativeHelper const& helper);
+
+} // mrdocs
+
+#endif // MRDOCS_LIB_SUPPORT_HELPERPLUGIN_HPP
@@ -15,7 +15,12 @@
 #include <mrdocs/Support/JavaScript.hpp>
 #include <llvm/Support/raw_ostream.h>
 #include <duktape.h>
+#include <cstring>
 #include <format>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <variant>
 
@@ -280,18 +285,78 @@ compile_script(
     return Access::construct<Value>(-1, *this);
 }
 
+namespace {
+/* Bytecode of the functions compiled by any context
+
+   Loading bytecode is much cheaper than compiling
+   the source again, and each thread compiles the
+   same helper scripts in its own context.
+ */
+class BytecodeCache
+{
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<std::string const>> bytecode_;
+
+public:
+    std::shared_ptr<std::string const>
+    find(std::string_view jsCode)
+    {
+        std::lock_guard lock(mutex_);
+        auto it = bytecode_.find(std::string(jsCode));
+        MRDOCS_CHECK_OR(it != bytecode_.end(), nullptr);
+        return it->second;
+    }
+
+    void
+    insert(std::string_view jsCode, std::string bytecode)
+    {
+        std::lock_guard lock(mutex_);
+        bytecode_.try_emplace(
+            std::string(jsCode),
+            std::make_shared<std::string const>(std::move(bytecode)));
+    }
+};
+
+BytecodeCache&
+bytecodeCache()
+{
+    static BytecodeCache cache;
+    return cache;
+}
+} // (anon)
+
 Expected<Value>
 Scope::
 compile_function(
     std::string_view jsCode)
 {
     Access A(*this);
+    BytecodeCache& cache = bytecodeCache();
+    if (auto bytecode = cache.find(jsCode))
+    {
+        void* buf = duk_push_fixed_buffer(A, bytecode->size());
+        std::memcpy(buf, bytecode->data(), bytecode->size());
+        duk_load_function(A);
+        return Access::construct<Value>(-1, *this);
+    }
+
     duk_int_t failed = duk_pcompile_lstring(
         A, DUK_COMPILE_FUNCTION, jsCode.data(), jsCode.size());
     if (failed)
     {
         return Unexpected(dukM_popError(A));
     }
+
+    // Store the bytecode for other contexts. Loaded
+    // functions keep the name binding of named
+    // function expressions, so recursive helpers
+    // work in every context.
+    duk_dup_top(A);
+    duk_dump_function(A);
+    duk_size_t size = 0;
+    void const* data = duk_get_buffer(A, -1, &size);
+    cache.insert(jsCode, std::string(static_cast<char const*>(data), size));
+    duk_pop(A);
     return Access::construct<Value>(-1, *this);
 }
 
@@ -717,6 +782,132 @@ domFunction_push(
     std::construct_at(data_ptr, fn);
 }
 
+/* Proxies of the C++ objects and arrays in a heap
+
+   The table in the heap stash maps the address of
+   each dom::ObjectImpl or dom::ArrayImpl to its
+   proxy, so the same C++ object is always the same
+   JS object and its proxy is only created once.
+
+   Duktape has no weak references, so the table
+   keeps the proxies alive. It is replaced by an
+   empty table when it is full. The proxies in the
+   old table remain valid while JS refers to them.
+ */
+constexpr duk_uint_t maxDomProxies = 4096;
+
+// ... -> ... [proxy] if the proxy exists
+bool
+domProxy_find(
+    Access& A, void const* impl)
+{
+    // ... -> ... [stash] [proxies]
+    duk_push_heap_stash(A);
+    if (!duk_get_prop_string(A, -1, "domProxies"))
+    {
+        duk_pop_2(A);
+        return false;
+    }
+    // ... [stash] [proxies] -> ... [stash] [proxies] [proxy]
+    std::string const key = std::format("{}", impl);
+    if (!duk_get_prop_lstring(A, -1, key.data(), key.size()))
+    {
+        duk_pop_3(A);
+        return false;
+    }
+    // ... [stash] [proxies] [proxy] -> ... [proxy]
+    duk_replace(A, -3);
+    duk_pop(A);
+    return true;
+}
+
+// ... [proxy] -> ... [proxy]
+void
+domProxy_insert(
+    Access& A, void const* impl)
+{
+    // ... [proxy] -> ... [proxy] [stash] [proxies]
+    duk_push_heap_stash(A);
+    duk_get_prop_string(A, -1, "domProxies");
+    duk_uint_t size = 0;
+    if (duk_is_object(A, -1))
+    {
+        duk_get_prop_string(A, -1, DUK_HIDDEN_SYMBOL("size"));
+        size = duk_get_uint(A, -1);
+        duk_pop(A);
+    }
+    if (size == 0 || size >= maxDomProxies)
+    {
+        // ... [proxy] [stash] [old] -> ... [proxy] [stash] [proxies]
+        duk_pop(A);
+        duk_push_bare_object(A);
+        duk_dup_top(A);
+        duk_put_prop_string(A, -3, "domProxies");
+        size = 0;
+    }
+    duk_push_uint(A, size + 1);
+    duk_put_prop_string(A, -2, DUK_HIDDEN_SYMBOL("size"));
+    // ... [proxy] [stash] [proxies] -> ... [proxy] [stash] [proxies] [proxy]
+    duk_dup(A, -3);
+    std::string const key = std::format("{}", impl);
+    duk_put_prop_lstring(A, -2, key.data(), key.size());
+    // ... [proxy] [stash] [proxies] -> ... [proxy]
+    duk_pop_2(A);
+}
+
+/* Objects with at most this many properties have
+   their primitive values copied to the proxy target
+
+   This only applies to lazy objects, whose values
+   do not change once they are converted, so the
+   get trap can return the copies without asking
+   the dom::Object again.
+ */
+constexpr std::size_t maxMaterializedProperties = 16;
+
+// ... [target] -> ... [target]
+void
+domObject_materialize(
+    Access& A, dom::Object const& obj)
+{
+    MRDOCS_CHECK_OR(std::string_view(obj.type_key()) == "LazyObject");
+    MRDOCS_CHECK_OR(obj.size() <= maxMaterializedProperties);
+    // ... [target] -> ... [target] [values]
+    duk_push_bare_object(A);
+    obj.visit([&](dom::String const& key, dom::Value const& value)
+    {
+        switch (value.kind())
+        {
+        case dom::Kind::Null:
+        case dom::Kind::Boolean:
+        case dom::Kind::Integer:
+        case dom::Kind::String:
+        case dom::Kind::SafeString:
+            // ... [target] [values] -> ... [target] [values] [value]
+            domValue_push(A, value);
+            // ... [target] [values] [value] -> ... [target] [values]
+            dukM_put_prop_string(A, -2, key);
+            break;
+        default:
+            break;
+        }
+    });
+    // ... [target] [values] -> ... [target]
+    dukM_put_prop_string(A, -2, DUK_HIDDEN_SYMBOL("values"));
+}
+
+// Remove a materialized value from the target at idx
+void
+domObject_forget(
+    Access& A, duk_idx_t idx, std::string_view key)
+{
+    if (duk_get_prop_string(A, idx, DUK_HIDDEN_SYMBOL("values")))
+    {
+        duk_del_prop_lstring(A, -1, key.data(), key.size());
+    }
+    duk_pop(A);
+}
+
 void
 domObject_push(
     Access& A, dom::Object const& obj)
@@ -731,6 +922,12 @@ domObject_push(
         return;
     }
 
+    // Reuse the proxy of the same dom::Object
+    if (domProxy_find(A, ptr))
+    {
+        return;
+    }
+
     // Underlying object is a C++ dom::Object
     // https://wiki.duktape.org/howtovirtualproperties#ecmascript-e6-proxy-subset
     // https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Proxy
@@ -759,6 +956,9 @@ domObject_push(
     auto data_ptr = static_cast<dom::Object*>(data);
     std::construct_at(data_ptr, obj);
 
+    // Copy the primitive values of small objects
+    domObject_materialize(A, obj);
+
     // Create a Proxy handler object
     // ... [target] [handler]
     duk_push_object(A);
@@ -777,6 +977,18 @@ domObject_push(
     {
         // [target] [key] [recv]
         Access A(ctx);
+        // [target] [key] [recv] -> [target] [key] [recv] [values]
+        if (duk_get_prop_string(ctx, 0, DUK_HIDDEN_SYMBOL("values")))
+        {
+            // [target] [key] [recv] [values] -> [target] [key] [recv] [values] [value]
+            duk_dup(ctx, 1);
+            if (duk_get_prop(ctx, -2))
+            {
+                return 1;
+            }
+            duk_pop(ctx);
+        }
+        duk_pop(ctx);
         auto* obj = domHiddenGet<dom::Object>(ctx, 0);
         std::string_view key = dukM_get_string(A, 1);
         dom::Value value = obj->get(key);
@@ -811,6 +1023,7 @@ domObject_push(
         std::string_view key = dukM_get_string(A, 1);
         dom::Value value = domValue_get(A, 2);
         obj->set(key, value);
+        domObject_forget(A, 0, key);
         duk_push_boolean(A, true);
         return 1;
     }, 4);
@@ -852,6 +1065,7 @@ domObject_push(
         if (exists)
         {
             obj->set(key, dom::Value(dom::Kind::Undefined));
+            domObject_forget(A, 0, key);
         }
         duk_push_boolean(A, exists);
         return 1;
@@ -861,6 +1075,7 @@ domObject_push(
 
     // ... [target] [handler] -> ... [proxy]
     duk_push_proxy(A, 0);
+    domProxy_insert(A, ptr);
 }
 
 /* Get a value in the stack as an index
@@ -918,6 +1133,12 @@ domArray_push(
         return;
     }
 
+    // Reuse the proxy of the same dom::Array
+    if (domProxy_find(A, ptr))
+    {
+        return;
+    }
+
     // Underlying object is a C++ dom::Array
     // https://wiki.duktape.org/howtovirtualproperties#ecmascript-e6-proxy-subset
     // https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Proxy
@@ -1097,6 +1318,7 @@ domArray_push(
 
     // ... [target] [handler] -> ... [proxy array]
     duk_push_proxy(A, 0);
+    domProxy_insert(A, ptr);
 }
 
 // return a dom::Value from a stack element
@@ -21,6 +21,9 @@
 #include <mrdocs/Support/Concepts.hpp>
 #include <mrdocs/Support/TypeTraits.hpp>
 #include <algorithm>
+#include <array>
+#include <map>
+#include <mutex>
 #include <ranges>
 #include <string_view>
 #include <unordered_map>
@@ -123,24 +126,108 @@ class LegibleNames::Impl
      */
     UnorderedStringMultiMap<LegibleName*> disambiguation_map_;
 
+    /*  Location of the names of a symbol in the arenas
+
+        The qualified names for each delimiter have
+        the same layout, so a single entry locates
+        the names in every arena. The unqualified
+        name is the suffix of the qualified name.
+     */
+    struct Entry
+    {
+        std::size_t offset;
+        std::size_t size;
+        std::size_t unqualifiedSize;
+    };
+
+    /* The qualified names of all symbols, one arena per delimiter
+     */
+    std::array<std::string, delimiters.size()> arenas_;
+
+    /* A map from SymbolID to the location of its names
+     */
+    std::unordered_map<SymbolID, Entry> index_;
+
+    /* Names that were not precomputed, built on demand
+
+       The key is the symbol and the delimiter, or
+       a null character for the unqualified name.
+       Map nodes are stable, so views to the names
+       remain valid.
+     */
+    std::map<std::pair<SymbolID, char>, std::string> late_;
+    std::mutex lateMutex_;
+
+    bool const enabled_;
+
 public:
-    /*  Build the map of legible names for all symbols in the corpus
+    /*  Build the table of legible names for all symbols in the corpus
      */
-    Impl(Corpus const& corpus, std::string_view const global_ns)
+    Impl(
+        Corpus const& corpus,
+        std::string_view const global_ns,
+        bool const enabled)
         : corpus_(corpus)
         , global_ns_(global_ns)
+        , enabled_(enabled)
     {
-        NamespaceSymbol const& global = corpus_.globalNamespace();
+        if (enabled)
+        {
+            NamespaceSymbol const& global = corpus_.globalNamespace();
 
-        // Treat the global namespace as-if its "name"
-        // is in the same scope as its members
-        buildLegibleMember(global, global_ns_);
-        visit(global, *this);
+            // Treat the global namespace as-if its "name"
+            // is in the same scope as its members
+            buildLegibleMember(global, global_ns_);
+            visit(global, *this);
 
-        // after generating legible names for every symbol,
-        // set the number of disambiguation characters
-        // used for the global namespace to zero
-        map_.at(global.id).disambig_chars = 0;
+            // after generating legible names for every symbol,
+            // set the number of disambiguation characters
+            // used for the global namespace to zero
+            map_.at(global.id).disambig_chars = 0;
+        }
+
+        // Qualify every symbol once, so lookups
+        // never build or allocate a name
+        for (Symbol const& I : corpus_)
+        {
+            if (enabled)
+            {
+                qualify(I.id);
+            }
+            else
+            {
+                addUnqualified(I.id, toBase16(I.id));
+            }
+        }
+
+        disambiguation_map_.clear();
+    }
+
+    std::string_view
+    getQualified(SymbolID const& id, char const delim)
+    {
+        std::size_t const k = delimiters.find(delim);
+        auto const it = index_.find(id);
+        if (k == std::string_view::npos || it == index_.end())
+        {
+            return getLate(id, delim);
+        }
+        Entry const& entry = it->second;
+        return std::string_view(arenas_[k]).substr(entry.offset, entry.size);
+    }
+
+    std::string_view
+    getUnqualified(SymbolID const& id)
+    {
+        auto const it = index_.find(id);
+        if (it == index_.end())
+        {
+            return getLate(id, '\0');
+        }
+        Entry const& entry = it->second;
+        return std::string_view(arenas_.front()).substr(
+            entry.offset + entry.size - entry.unqualifiedSize,
+            entry.unqualifiedSize);
     }
 
     /*  Visit a symbol and build legible names for its members
@@ -318,7 +405,7 @@ public:
         result.reserve(
             result.size() +
             unqualified.size() +
-            n_disambig ? n_disambig + 2 : 0);
+            (n_disambig ? n_disambig + 2 : 0));
         result.append(unqualified);
 
         // Append a disambiguation suffix from the symbol ID if needed
@@ -350,6 +437,87 @@ public:
         }
         getLegibleUnqualified(result, id);
     }
+
+private:
+    /*  Build a name that was not precomputed
+
+        @param delim The delimiter of the qualified
+        name, or a null character for the
+        unqualified name.
+     */
+    std::string_view
+    getLate(SymbolID const& id, char const delim)
+    {
+        std::lock_guard lock(lateMutex_);
+        std::pair const key(id, delim);
+        if (auto const it = late_.find(key); it != late_.end())
+        {
+            return it->second;
+        }
+        std::string result;
+        if (!enabled_)
+        {
+            result = toBase16(id);
+        }
+        else if (delim == '\0')
+        {
+            getLegibleUnqualified(result, id);
+        }
+        else
+        {
+            getLegibleQualified(result, id, delim);
+        }
+        return late_.emplace(key, std::move(result)).first->second;
+    }
+
+    /*  Add the names of a symbol without a qualified parent
+     */
+    Entry const&
+    addUnqualified(SymbolID const& id, std::string_view name)
+    {
+        Entry const entry{arenas_.front().size(), name.size(), name.size()};
+        for (std::string& arena : arenas_)
+        {
+            arena.append(name);
+        }
+        return index_.emplace(id, entry).first->second;
+    }
+
+    /*  Add the qualified names of a symbol and its parents
+     */
+    Entry const&
+    qualify(SymbolID const& id)
+    {
+        if (auto const it = index_.find(id); it != index_.end())
+        {
+            return it->second;
+        }
+
+        std::string name;
+        getLegibleUnqualified(name, id);
+
+        auto const& I = corpus_.get(id);
+        if (I.Parent == SymbolID::invalid ||
+            I.Parent == SymbolID::global)
+        {
+            return addUnqualified(id, name);
+        }
+
+        // Copied, because adding entries can rehash the index
+        Entry const parent = qualify(I.Parent);
+        Entry const entry{
+            arenas_.front().size(),
+            parent.size + 1 + name.size(),
+            name.size()};
+        for (std::size_t k = 0; k < arenas_.size(); ++k)
+        {
+            std::string& arena = arenas_[k];
+            arena.append(arena, parent.offset, parent.size);
+            arena.push_back(delimiters[k]);
+            arena.append(name);
+        }
+        return index_.emplace(id, entry).first->second;
+    }
 };
 
 //------------------------------------------------
@@ -358,43 +526,28 @@ LegibleNames::
 LegibleNames(
     Corpus const& corpus,
     bool const enabled)
+    : impl_(std::make_unique<Impl>(corpus, "index", enabled))
 {
-    if (enabled)
-    {
-        impl_ = std::make_unique<Impl>(corpus, "index");
-    }
 }
 
 LegibleNames::
 ~LegibleNames() noexcept = default;
 
-std::string
+std::string_view
 LegibleNames::
 getUnqualified(
     SymbolID const& id) const
 {
-    if (!impl_)
-    {
-        return toBase16(id);
-    }
-    std::string result;
-    impl_->getLegibleUnqualified(result, id);
-    return result;
+    return impl_->getUnqualified(id);
 }
 
-std::string
+std::string_view
 LegibleNames::
 getQualified(
     SymbolID const& id,
     char const delim) const
 {
-    if (!impl_)
-    {
-        return toBase16(id);
-    }
-    std::string result;
-    impl_->getLegibleQualified(result, id, delim);
-    return result;
+    return impl_->getQualified(id, delim);
 }
 
 } // mrdocs
@@ -16,6 +16,7 @@
 #include <mrdocs/Metadata/Symbol/SymbolID.hpp>
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace mrdocs {
 
@@ -37,10 +38,19 @@ class LegibleNames
     std::unique_ptr<Impl> impl_;
 
 public:
+    /** The delimiters of the precomputed qualified names.
+
+        Qualified names with other delimiters are
+        built on demand.
+     */
+    static constexpr std::string_view delimiters = "-/";
+
     /** Constructor.
 
         Upon construction, the entire table of
-        legible names is built from the corpus.
+        legible names is built from the corpus,
+        including the qualified names for each
+        of the @ref delimiters.
     */
     LegibleNames(
         Corpus const& corpus,
@@ -51,11 +61,25 @@ public:
     ~LegibleNames() noexcept;
 
     /** Return the legible name for a symbol name.
+
+        The returned view is valid for the
+        lifetime of this object.
      */
-    std::string
+    std::string_view
     getUnqualified(SymbolID const& id) const;
 
-    std::string
+    /** Return the legible name qualified by the names of the parents.
+
+        The returned view is valid for the
+        lifetime of this object.
+
+        @param id The symbol
+        @param delim The delimiter between names.
+        The names for the @ref delimiters are
+        precomputed, and the names for any other
+        delimiter are built on first use.
+     */
+    std::string_view
     getQualified(
         SymbolID const& id,
         char delim = '-') const;
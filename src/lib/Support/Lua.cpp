@@ -9,6 +9,7 @@
 //
 
 #include <lib/Support/LuaHandlebars.hpp>
+#include <mrdocs/Support/Handlebars.hpp>
 #include <mrdocs/Support/Lua.hpp>
 #include <mrdocs/Support/Path.hpp>
 #include <mrdocs/Support/Report.hpp>
@@ -35,6 +36,7 @@ static char gImplKey{};
 
 static void domObject_push_metatable(Access& A);
 static void domValue_push(Access& A, dom::Value const&);
+static dom::Value domValue_get(Access& A, int index);
 
 //------------------------------------------------
 //
@@ -48,6 +50,7 @@ struct Context::Impl
 
     int objMetaRef = LUA_NOREF;
     int arrMetaRef = LUA_NOREF;
+    int fnMetaRef = LUA_NOREF;
 
     ~Impl();
     Impl();
@@ -260,6 +263,21 @@ luaM_pushstring(
     lua_pushlstring(L, s.data(), s.size());
 }
 
+// Return true if the value at the given stack
+// index has the metatable stored at ref.
+static
+bool
+luaM_hasmetatable(
+    lua_State* L, int index, int ref)
+{
+    if(ref == LUA_NOREF || ! lua_getmetatable(L, index))
+        return false;
+    lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+    bool const result = lua_rawequal(L, -1, -2);
+    lua_pop(L, 2);
+    return result;
+}
+
 //------------------------------------------------
 //
 // dom::Array
@@ -278,8 +296,7 @@ domArray_get(
         lua_touserdata(A, index));
 }
 
-// Push the domObject metatable onto the stack
-[[maybe_unused]]
+// Push the domArray metatable onto the stack
 static
 void
 domArray_push_metatable(
@@ -291,42 +308,40 @@ domArray_push_metatable(
         return;
     }
 
-    lua_createtable(A, 0, 3);
+    lua_createtable(A, 0, 5);
 
     // Effect:      return t[i]
     // Signature:   (t, i)
+    // Indices start at 1, as in Lua sequences.
     luaM_pushstring(A, "__index");
     lua_pushcfunction(A,
     [](lua_State* L)
     {
         Access A(L);
-        if(! lua_isnumber(A, 2))
-        {
-            lua_pop(A, lua_gettop(A));
-            lua_pushnil(A);
-            return 1;
-        }
-        std::size_t index = lua_tonumber(A, 2);
         auto const& arr = domArray_get(A, 1);
-        lua_pop(A, lua_gettop(A));
-        if(index < arr.size())
-            domValue_push(A, arr.at(index));
+        lua_Integer const index = lua_isinteger(A, 2) ?
+            lua_tointeger(A, 2) : 0;
+        if(index >= 1 &&
+            static_cast<std::size_t>(index) <= arr.size())
+            domValue_push(A, arr.get(index - 1));
         else
             lua_pushnil(A);
         return 1;
     });
     lua_settable(A, -3);
 
-#if 0
-    // Effect:      t[k] = v
-    // Signature:   (t, k, v)
-    luaM_pushstring(A, "__newindex");
+    // Effect:      return #t
+    // Signature:   (t)
+    luaM_pushstring(A, "__len");
     lua_pushcfunction(A,
     [](lua_State* L)
     {
+        Access A(L);
+        lua_pushinteger(A, static_cast<lua_Integer>(
+            domArray_get(A, 1).size()));
+        return 1;
     });
     lua_settable(A, -3);
-#endif
 
     // Effect:      return next(t [, index])
     // Signature:   (t [, index])
@@ -334,25 +349,17 @@ domArray_push_metatable(
     [](lua_State* L)
     {
         Access A(L);
-        auto const narg = lua_gettop(A);
-        auto arr = domArray_get(A, 1);
-        lua_pop(A, narg);
-        if( arr.empty() ||
-            lua_isnil(A, lua_upvalueindex(1)))
+        auto const& arr = domArray_get(A, 1);
+        auto const i = lua_tointeger(A, lua_upvalueindex(1));
+        if(static_cast<std::size_t>(i) >= arr.size())
         {
             lua_pushnil(A);
-            lua_pushnil(A);
-            return 2;
+            return 1;
         }
-        auto index = lua_tonumber(A, lua_upvalueindex(1));
-        lua_pushnumber(A, index);
-        domValue_push(A, arr.at(index));
-        ++index;
-        if(index < arr.size())
-            lua_pushnumber(A, index);
-        else
-            lua_pushnil(A);
+        lua_pushinteger(A, i + 1);
         lua_replace(A, lua_upvalueindex(1));
+        lua_pushinteger(A, i + 1);
+        domValue_push(A, arr.get(i));
         return 2;
     };
 
@@ -363,13 +370,9 @@ domArray_push_metatable(
     [](lua_State* L)
     {
         Access A(L);
-        auto arr = domArray_get(A, 1);
-        if(! arr.empty())
-            lua_pushnumber(A, 0);
-        else
-            lua_pushnil(A);
+        lua_pushinteger(A, 0);
         lua_pushcclosure(A, next, 1);
-        lua_rotate(A, -2, 1);
+        lua_pushvalue(A, 1);
         lua_pushnil(A);
         return 3;
     });
@@ -391,6 +394,24 @@ domArray_push_metatable(
     A->arrMetaRef = luaL_ref(A, LUA_REGISTRYINDEX);
 }
 
+// Push a dom::Array onto the stack
+//
+// The userdata refers to the same array,
+// so the elements are not copied.
+static
+void
+domArray_push(
+    Access& A,
+    dom::Array const& arr)
+{
+    auto& arr_ = *static_cast<
+        dom::Array*>(lua_newuserdatauv(
+            A, sizeof(dom::Array), 0));
+    std::construct_at(&arr_, arr);
+    domArray_push_metatable(A);
+    lua_setmetatable(A, -2);
+}
+
 //------------------------------------------------
 //
 // dom::Object
@@ -421,7 +442,7 @@ domObject_push_metatable(
         return;
     }
 
-    lua_createtable(A, 0, 4);
+    lua_createtable(A, 0, 5);
 
     // Effect:      return t[k]
     // Signature:   (t, k)
@@ -430,10 +451,14 @@ domObject_push_metatable(
     [](lua_State* L)
     {
         Access A(L);
+        if(lua_type(A, 2) != LUA_TSTRING)
+        {
+            lua_pushnil(A);
+            return 1;
+        }
         domValue_push(A,
             domObject_get(A, 1).get(
                 luaM_getstring(A, 2)));
-        lua_replace(A, 1);
         return 1;
     });
     lua_settable(A, -3);
@@ -447,42 +472,24 @@ domObject_push_metatable(
         Access A(L);
         auto& obj = domObject_get(A, 1);
         auto key = luaM_getstring(A, 2);
-        switch(lua_type(A, 3))
-        {
-        case LUA_TNIL:
-            // VFALCO should erase instead?
-            obj.set(key, nullptr);
-            break;
-        case LUA_TBOOLEAN:
-            obj.set(key, lua_toboolean(A, 3) != 0);
-            break;
-        case LUA_TLIGHTUSERDATA:
-            MRDOCS_UNREACHABLE();
-        case LUA_TNUMBER:
-            obj.set(key, lua_tonumber(A, 3));
-            break;
-        case LUA_TSTRING:
-            obj.set(key, luaM_getstring(A, 3));
-            break;
-        case LUA_TTABLE:
-            // VFALCO TODO
-            MRDOCS_UNREACHABLE();
-            break;
-        case LUA_TFUNCTION:
-            // VFALCO TODO
-            MRDOCS_UNREACHABLE();
-            break;
-        case LUA_TUSERDATA:
-            MRDOCS_UNREACHABLE();
-        case LUA_TTHREAD:
-            MRDOCS_UNREACHABLE();
-        default:
-            MRDOCS_UNREACHABLE();
-        }
+        obj.set(key, domValue_get(A, 3));
         return 0;
     });
     lua_settable(A, -3);
 
+    // Effect:      return #t
+    // Signature:   (t)
+    luaM_pushstring(A, "__len");
+    lua_pushcfunction(A,
+    [](lua_State* L)
+    {
+        Access A(L);
+        lua_pushinteger(A, static_cast<lua_Integer>(
+            domObject_get(A, 1).size()));
+        return 1;
+    });
+    lua_settable(A, -3);
+
     // Effect:      return pairs(t)
     // Signature:   (t)
     luaM_pushstring(A, "__pairs");
@@ -555,6 +562,9 @@ domObject_push_metatable(
 }
 
 // Push a dom::Object onto the stack
+//
+// The userdata refers to the same object,
+// so the properties are not copied.
 static
 void
 domObject_push(
@@ -564,9 +574,110 @@ domObject_push(
     auto& obj_ = *static_cast<
         dom::Object*>(lua_newuserdatauv(
             A, sizeof(dom::Object), 0));
+    std::construct_at(&obj_, obj);
     domObject_push_metatable(A);
     lua_setmetatable(A, -2);
-    std::construct_at(&obj_, obj);
+}
+
+//------------------------------------------------
+//
+// dom::Function
+//
+//------------------------------------------------
+
+// Return a userdata as a dom::Function&
+static
+dom::Function&
+domFunction_get(
+    Access& A, int index)
+{
+    MRDOCS_ASSERT(
+        lua_type(A, index) == LUA_TUSERDATA);
+    return *static_cast<dom::Function*>(
+        lua_touserdata(A, index));
+}
+
+// Push the domFunction metatable onto the stack
+static
+void
+domFunction_push_metatable(
+    Access& A)
+{
+    if(A->fnMetaRef != LUA_NOREF)
+    {
+        lua_rawgeti(A, LUA_REGISTRYINDEX, A->fnMetaRef);
+        return;
+    }
+
+    lua_createtable(A, 0, 2);
+
+    // Effect:      return f(...)
+    // Signature:   (f, ...)
+    luaM_pushstring(A, "__call");
+    lua_pushcfunction(A,
+    [](lua_State* L)
+    {
+        Access A(L);
+        bool failed = false;
+        {
+            // C++ objects must be destroyed
+            // before lua_error unwinds the stack
+            dom::Array args;
+            int const n = lua_gettop(A);
+            for(int i = 2; i <= n; ++i)
+                args.push_back(domValue_get(A, i));
+            try
+            {
+                auto exp = domFunction_get(A, 1).call(args);
+                if(exp)
+                    domValue_push(A, *exp);
+                else
+                {
+                    luaM_pushstring(A, exp.error().message());
+                    failed = true;
+                }
+            }
+            catch(std::exception const& ex)
+            {
+                luaM_pushstring(A, ex.what());
+                failed = true;
+            }
+        }
+        if(failed)
+            return lua_error(A);
+        return 1;
+    });
+    lua_settable(A, -3);
+
+    // Effect:      ~dom::Function
+    // Signature:   (f)
+    luaM_pushstring(A, "__gc");
+    lua_pushcfunction(A,
+    [](lua_State* L)
+    {
+        Access A(L);
+        std::destroy_at(&domFunction_get(A, 1));
+        return 0;
+    });
+    lua_settable(A, -3);
+
+    lua_pushvalue(A, -1);
+    A->fnMetaRef = luaL_ref(A, LUA_REGISTRYINDEX);
+}
+
+// Push a dom::Function onto the stack
+static
+void
+domFunction_push(
+    Access& A,
+    dom::Function const& fn)
+{
+    auto& fn_ = *static_cast<
+        dom::Function*>(lua_newuserdatauv(
+            A, sizeof(dom::Function), 0));
+    std::construct_at(&fn_, fn);
+    domFunction_push_metatable(A);
+    lua_setmetatable(A, -2);
 }
 
 //------------------------------------------------
@@ -582,24 +693,94 @@ domValue_push(
 {
     switch(value.kind())
     {
+    case dom::Kind::Undefined:
     case dom::Kind::Null:
         return lua_pushnil(A);
     case dom::Kind::Boolean:
         return lua_pushboolean(A, value.getBool());
     case dom::Kind::Integer:
-        return lua_pushnumber(A, value.getInteger());
+        return lua_pushinteger(A, value.getInteger());
     case dom::Kind::String:
+    case dom::Kind::SafeString:
         return luaM_pushstring(A, value.getString());
     case dom::Kind::Array:
-        MRDOCS_UNREACHABLE();
-        //return domArray_push(A, value.getArray());
+        return domArray_push(A, value.getArray());
     case dom::Kind::Object:
         return domObject_push(A, value.getObject());
+    case dom::Kind::Function:
+        return domFunction_push(A, value.getFunction());
     default:
         MRDOCS_UNREACHABLE();
     }
 }
 
+// Return the value at the given stack index
+// as a dom::Value.
+//
+// Userdata created by domValue_push are converted
+// back to the original values. Lua tables are
+// copied: sequences become arrays and other
+// tables become objects.
+static
+dom::Value
+domValue_get(
+    Access& A,
+    int index)
+{
+    index = lua_absindex(A, index);
+    switch(lua_type(A, index))
+    {
+    case LUA_TNIL:
+        return nullptr;
+    case LUA_TBOOLEAN:
+        return lua_toboolean(A, index) != 0;
+    case LUA_TNUMBER:
+        if(lua_isinteger(A, index))
+            return static_cast<std::int64_t>(
+                lua_tointeger(A, index));
+        return static_cast<std::int64_t>(
+            lua_tonumber(A, index));
+    case LUA_TSTRING:
+        return luaM_getstring(A, index);
+    case LUA_TUSERDATA:
+        if(luaM_hasmetatable(A, index, A->objMetaRef))
+            return domObject_get(A, index);
+        if(luaM_hasmetatable(A, index, A->arrMetaRef))
+            return domArray_get(A, index);
+        if(luaM_hasmetatable(A, index, A->fnMetaRef))
+            return domFunction_get(A, index);
+        return dom::Kind::Undefined;
+    case LUA_TTABLE:
+    {
+        if(auto const n = lua_rawlen(A, index); n > 0)
+        {
+            dom::Array arr;
+            for(lua_Integer i = 1; i <= static_cast<lua_Integer>(n); ++i)
+            {
+                lua_rawgeti(A, index, i);
+                arr.push_back(domValue_get(A, -1));
+                lua_pop(A, 1);
+            }
+            return arr;
+        }
+        dom::Object obj;
+        lua_pushnil(A);
+        while(lua_next(A, index) != 0)
+        {
+            // Only string keys are properties. Keys
+            // are not converted in place because that
+            // would confuse lua_next.
+            if(lua_type(A, -2) == LUA_TSTRING)
+                obj.set(luaM_getstring(A, -2), domValue_get(A, -1));
+            lua_pop(A, 1);
+        }
+        return obj;
+    }
+    default:
+        return dom::Kind::Undefined;
+    }
+}
+
 //------------------------------------------------
 
 static
@@ -711,7 +892,8 @@ push(Scope& scope) const
     case Kind::value:
         return lua_pushvalue(A, index_);
     case Kind::domArray:
-        MRDOCS_UNREACHABLE();
+        domArray_push(A, arr_);
+        return;
     case Kind::domObject:
         domObject_push(A, obj_);
         return;
@@ -832,6 +1014,7 @@ Param(
         {
             switch(value.kind())
             {
+            case dom::Kind::Undefined:
             case dom::Kind::Null:
                 return Param(nullptr);
             case dom::Kind::Boolean:
@@ -840,6 +1023,7 @@ Param(
                 return Param(static_cast<lua_Integer>(
                     value.getInteger()));
             case dom::Kind::String:
+            case dom::Kind::SafeString:
                 return Param(value.getString());
             case dom::Kind::Array:
                 return Param(value.getArray());
@@ -1158,6 +1342,53 @@ callImpl(
 
 //------------------------------------------------
 
+Expected<void, Error>
+registerHelper(
+    mrdocs::Handlebars& hbs,
+    std::string_view name,
+    Context const& ctx,
+    std::string_view script)
+{
+    // Run the chunk to get the helper function
+    Access A(ctx);
+    std::string const chunkName = std::format("={}", name);
+    if(luaL_loadbufferx(A, script.data(), script.size(),
+            chunkName.c_str(), "t") != LUA_OK)
+        return Unexpected(luaM_popError(A));
+    if(lua_pcall(A, 0, 1, 0) != LUA_OK)
+        return Unexpected(luaM_popError(A));
+    if(! lua_isfunction(A, -1))
+    {
+        lua_pop(A, 1);
+        return Unexpected(formatError(
+            "helper \"{}\" is not a function", name));
+    }
+
+    // Keep the function in the registry. The helper
+    // holds a reference to the context, so the
+    // function lives as long as the helper.
+    int const ref = luaL_ref(A, LUA_REGISTRYINDEX);
+    hbs.registerHelper(name, dom::makeVariadicInvocable(
+        [ctx, ref, name = std::string(name)](
+            dom::Array const& args) -> Expected<dom::Value>
+        {
+            Access A(ctx);
+            int const top = lua_gettop(A);
+            lua_rawgeti(A, LUA_REGISTRYINDEX, ref);
+            for(auto const& arg : args)
+                domValue_push(A, arg);
+            if(lua_pcall(A, static_cast<int>(args.size()), 1, 0) != LUA_OK)
+                return Unexpected(formatError(
+                    "{}: {}", name, luaM_popError(A).message()));
+            dom::Value result = domValue_get(A, -1);
+            lua_settop(A, top);
+            return result;
+        }));
+    return {};
+}
+
+//------------------------------------------------
+
 void
 lua_dump(dom::Object const& obj)
 {
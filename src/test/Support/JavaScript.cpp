@@ -188,6 +188,32 @@ struct JavaScript_test
                     BOOST_TEST(x.getDom() == 6);
                 }
             }
+
+            // function compiled again in another context
+            {
+                // Other contexts load the bytecode of the first
+                // one, and named functions can still call themselves
+                constexpr std::string_view code =
+                    "function sum_to_compiled_twice(n) {\n"
+                    "  return n <= 0 ? 0 : n + sum_to_compiled_twice(n - 1);\n"
+                    "}";
+                Context other;
+                for (Context const* c : {&ctx, &other})
+                {
+                    Scope scope(*c);
+                    Expected<Value> fnr = scope.compile_function(code);
+                    BOOST_TEST(fnr);
+                    if (!fnr)
+                    {
+                        continue;
+                    }
+                    Value fn = fnr.value();
+                    BOOST_TEST(fn.isFunction());
+                    Value x = fn(4);
+                    BOOST_TEST(x.isNumber());
+                    BOOST_TEST(x.getDom() == 10);
+                }
+            }
         }
 
         // getGlobal
@@ -1055,6 +1081,22 @@ struct JavaScript_test
             BOOST_TEST(o3.isObject());
             BOOST_TEST(o3.get("a") == 3);
         }
+
+        // The same C++ object is the same JS object
+        {
+            Scope scope(context);
+            dom::Object o1;
+            o1.set("a", 1);
+            scope.setGlobal("o", o1);
+            scope.setGlobal("p", o1);
+            scope.setGlobal("q", dom::Object{});
+            auto exp = scope.eval("o === p");
+            BOOST_TEST(exp);
+            BOOST_TEST(exp->getDom() == true);
+            exp = scope.eval("o === q");
+            BOOST_TEST(exp);
+            BOOST_TEST(exp->getDom() == false);
+        }
     }
 
     void
@@ -1233,6 +1275,17 @@ struct JavaScript_test
             BOOST_TEST(o3.isArray());
             BOOST_TEST(o3.get(0) == 3);
         }
+
+        // The same C++ array is the same JS array
+        {
+            Scope scope(context);
+            dom::Array a1({1, 2, 3});
+            scope.setGlobal("a", a1);
+            scope.setGlobal("b", a1);
+            auto exp = scope.eval("a === b");
+            BOOST_TEST(exp);
+            BOOST_TEST(exp->getDom() == true);
+        }
     }
 
     void
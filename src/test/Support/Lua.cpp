@@ -0,0 +1,100 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include <mrdocs/Support/Handlebars.hpp>
+#include <mrdocs/Support/Lua.hpp>
+#include <test_suite/test_suite.hpp>
+
+
+namespace mrdocs {
+namespace lua {
+
+struct Lua_test
+{
+    void
+    test_hbs_helpers()
+    {
+        Handlebars hbs;
+        lua::Context ctx;
+
+        // Primitive types
+        {
+            // Number
+            BOOST_TEST(registerHelper(hbs, "add", ctx,
+                "return function(a, b) return a + b end"));
+            BOOST_TEST(hbs.render("{{add 1 2}}") == "3");
+
+            // String
+            BOOST_TEST(registerHelper(hbs, "concat", ctx,
+                "return function(a, b) return a .. b end"));
+            BOOST_TEST(hbs.render("{{concat 'a' 'b'}}") == "ab");
+
+            // Boolean
+            BOOST_TEST(registerHelper(hbs, "and", ctx,
+                "return function(a, b) return a and b end"));
+            BOOST_TEST(hbs.render("{{and true true}}") == "true");
+
+            // Nil
+            BOOST_TEST(registerHelper(hbs, "null", ctx,
+                "return function() return nil end"));
+            BOOST_TEST(hbs.render("{{null}}") == "");
+        }
+
+        // Reference types
+        {
+            // Objects are passed by reference
+            BOOST_TEST(registerHelper(hbs, "prop", ctx,
+                "return function(o, k) return o[k] end"));
+            dom::Object o;
+            o.set("a", 1);
+            BOOST_TEST(hbs.render("{{prop this 'a'}}", o) == "1");
+
+            // Arrays are indexed from 1
+            BOOST_TEST(registerHelper(hbs, "first", ctx,
+                "return function(a) return a[1] end"));
+            BOOST_TEST(registerHelper(hbs, "len", ctx,
+                "return function(a) return #a end"));
+            dom::Object ctx2;
+            ctx2.set("arr", dom::Array({1, 2, 3}));
+            BOOST_TEST(hbs.render("{{first arr}}", ctx2) == "1");
+            BOOST_TEST(hbs.render("{{len arr}}", ctx2) == "3");
+
+            // Tables are converted to arrays and objects
+            BOOST_TEST(registerHelper(hbs, "seq", ctx,
+                "return function() return {1, 2, 3} end"));
+            BOOST_TEST(hbs.render("{{#each (seq)}}{{this}}{{/each}}") == "123");
+        }
+
+        // Access helper options from Lua
+        {
+            BOOST_TEST(registerHelper(hbs, "opt", ctx,
+                "return function(options) return options.hash.a end"));
+            BOOST_TEST(hbs.render("{{opt a=1}}") == "1");
+        }
+
+        // Invalid helpers
+        {
+            BOOST_TEST(!registerHelper(hbs, "syntax", ctx, "return function("));
+            BOOST_TEST(!registerHelper(hbs, "value", ctx, "return 1"));
+        }
+    }
+
+    void run()
+    {
+        test_hbs_helpers();
+    }
+};
+
+TEST_SUITE(
+    Lua_test,
+    "clang.mrdocs.Lua");
+
+} // lua
+} // mrdocs
@@ -48,6 +48,22 @@ tag_invoke(
     io.map("y", x.y);
 }
 
+struct Z {
+    mutable int calls = 0;
+    X x;
+};
+
+template <class IO>
+void
+tag_invoke(
+    dom::LazyObjectMapTag,
+    IO& io,
+    Z const& z)
+{
+    io.defer("calls", [&z]{ return ++z.calls; });
+    io.defer("x", [&z]{ return LazyObject(z.x); });
+}
+
 struct LazyObject_test
 {
     void
@@ -77,10 +93,48 @@ struct LazyObject_test
             BOOST_TEST(obj.get("s") == "hello");
         }
 
-        // Change value through the original object
+        // Mapped values are converted when the
+        // object is first accessed
         {
             x.i = 789;
-            BOOST_TEST(obj.get("i") == 789);
+            x.s = "world";
+            BOOST_TEST(obj.get("i") == 123);
+            BOOST_TEST(obj.get("s") == "hello");
+        }
+
+        // Deferred values are converted when
+        // they are first accessed
+        {
+            BOOST_TEST(obj.get("si") == "world789");
+        }
+    }
+
+    void
+    testMemoize()
+    {
+        Z z;
+        LazyObjectImpl<Z> obj(z);
+
+        // Deferred values are computed once
+        {
+            BOOST_TEST(obj.get("calls") == 1);
+            BOOST_TEST(obj.get("calls") == 1);
+            BOOST_TEST(z.calls == 1);
+        }
+
+        // Nested objects keep their identity
+        {
+            Value x1 = obj.get("x");
+            Value x2 = obj.get("x");
+            BOOST_TEST(x1.getObject().impl() == x2.getObject().impl());
+        }
+
+        // Visiting reuses memoized values
+        {
+            std::size_t count = 0;
+            obj.visit([&count](String, Value) { ++count; return true; });
+            BOOST_TEST(count == 2);
+            BOOST_TEST(z.calls == 1);
         }
     }
 
@@ -239,6 +293,7 @@ struct LazyObject_test
         testConstructor();
         testTypeKey();
         testGet();
+        testMemoize();
         testSet();
         testExists();
         testVisit();
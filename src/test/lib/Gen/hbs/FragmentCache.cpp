@@ -0,0 +1,103 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include <lib/Gen/hbs/FragmentCache.hpp>
+#include <test_suite/test_suite.hpp>
+#include <string>
+
+
+namespace mrdocs::hbs {
+
+struct FragmentCache_test
+{
+    static
+    FragmentCache
+    makeCache(std::size_t capacity)
+    {
+        std::map<std::string, std::vector<std::string>, std::less<>> keys;
+        keys["item"] = {"id", "@root.page"};
+        return FragmentCache(std::move(keys), capacity);
+    }
+
+    void
+    testKey()
+    {
+        FragmentCache cache = makeCache(1024 * 1024);
+        dom::Object root;
+        root.set("page", "index");
+
+        // Scalar values identify the output
+        {
+            dom::Object ctx;
+            ctx.set("id", "a");
+            std::string const key = cache.key("item", ctx, root);
+            BOOST_TEST_NOT(key.empty());
+            BOOST_TEST(key == cache.key("item", ctx, root));
+        }
+
+        // Partials without a cache key are not cached
+        {
+            dom::Object ctx;
+            ctx.set("id", "a");
+            BOOST_TEST(cache.key("other", ctx, root).empty());
+        }
+
+        // Objects and missing values can't identify the output
+        {
+            dom::Object ctx;
+            ctx.set("id", dom::Object());
+            BOOST_TEST(cache.key("item", ctx, root).empty());
+            BOOST_TEST(cache.key("item", dom::Object(), root).empty());
+        }
+    }
+
+    void
+    testEviction()
+    {
+        // Each shard holds 64 bytes
+        FragmentCache cache = makeCache(16 * 64);
+        std::string const fragment(40, 'x');
+
+        // Fragments larger than a shard are not stored
+        {
+            cache.insert("big", std::string(100, 'x'));
+            BOOST_TEST_NOT(cache.find("big"));
+        }
+
+        // Fragments are found after they are inserted
+        {
+            cache.insert("a", fragment);
+            BOOST_TEST(cache.find("a") == fragment);
+        }
+
+        // Inserting many fragments evicts the oldest ones
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                cache.insert(std::to_string(i), fragment);
+            }
+            BOOST_TEST_NOT(cache.find("a"));
+            BOOST_TEST(cache.find("255") == fragment);
+        }
+    }
+
+    void
+    run()
+    {
+        testKey();
+        testEviction();
+    }
+};
+
+TEST_SUITE(
+    FragmentCache_test,
+    "clang.mrdocs.FragmentCache");
+
+} // mrdocs::hbs
@@ -0,0 +1,123 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include <lib/Gen/hbs/PageManifest.hpp>
+#include <mrdocs/Support/Path.hpp>
+#include <test_suite/test_suite.hpp>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <fstream>
+#include <string>
+
+
+namespace mrdocs::hbs {
+
+struct PageManifest_test
+{
+    static
+    void
+    writeFile(std::string const& path, std::string_view text)
+    {
+        std::ofstream os(path, std::ios_base::binary | std::ios_base::trunc);
+        os << text;
+    }
+
+    void
+    testUpdate()
+    {
+        llvm::SmallString<128> tmp;
+        BOOST_TEST_NOT(llvm::sys::fs::createUniqueDirectory("mrdocs-manifest", tmp));
+        std::string const dir(tmp.str());
+        std::string const a = files::appendPath(dir, "a.html");
+        std::string const b = files::appendPath(dir, "b.html");
+        std::string const other = files::appendPath(dir, "other.txt");
+
+        // First run: new pages are written, and existing
+        // files with the same contents are kept
+        writeFile(b, "b");
+        writeFile(other, "other");
+        {
+            PageManifest manifest(dir);
+            BOOST_TEST(manifest.load());
+            BOOST_TEST(manifest.update(a, "a"));
+            BOOST_TEST_NOT(manifest.update(b, "b"));
+            writeFile(a, "a");
+            BOOST_TEST(manifest.unchanged() == 1);
+            BOOST_TEST(manifest.save());
+        }
+        BOOST_TEST(files::exists(files::appendPath(dir, PageManifest::fileName)));
+
+        // Second run: pages with the same hash are not
+        // written and stale pages are deleted
+        {
+            PageManifest manifest(dir);
+            BOOST_TEST(manifest.load());
+            BOOST_TEST_NOT(manifest.update(a, "a"));
+            BOOST_TEST(manifest.save());
+        }
+        BOOST_TEST(files::exists(a));
+        BOOST_TEST_NOT(files::exists(b));
+        BOOST_TEST(files::exists(other));
+
+        // Third run: changed pages are written
+        {
+            PageManifest manifest(dir);
+            BOOST_TEST(manifest.load());
+            BOOST_TEST(manifest.update(a, "a2"));
+            BOOST_TEST(manifest.unchanged() == 0);
+        }
+
+        llvm::sys::fs::remove_directories(dir);
+    }
+
+    void
+    testUnsafePaths()
+    {
+        llvm::SmallString<128> tmp;
+        BOOST_TEST_NOT(llvm::sys::fs::createUniqueDirectory("mrdocs-manifest", tmp));
+        std::string const root(tmp.str());
+        std::string const dir = files::appendPath(root, "out");
+        BOOST_TEST_NOT(llvm::sys::fs::create_directory(dir));
+        std::string const outside = files::appendPath(root, "outside.txt");
+        std::string const inside = files::appendPath(dir, "a.html");
+        writeFile(outside, "outside");
+        writeFile(inside, "a");
+
+        // Stale entries outside the directory are not deleted
+        writeFile(
+            files::appendPath(dir, PageManifest::fileName),
+            "0 ../outside.txt\n"
+            "0 sub/../../outside.txt\n"
+            "0 " + outside + "\n"
+            "0 a.html\n");
+        {
+            PageManifest manifest(dir);
+            BOOST_TEST(manifest.load());
+            BOOST_TEST(manifest.save());
+        }
+        BOOST_TEST(files::exists(outside));
+        BOOST_TEST_NOT(files::exists(inside));
+
+        llvm::sys::fs::remove_directories(root);
+    }
+
+    void
+    run()
+    {
+        testUpdate();
+        testUnsafePaths();
+    }
+};
+
+TEST_SUITE(
+    PageManifest_test,
+    "clang.mrdocs.PageManifest");
+
+} // mrdocs::hbs
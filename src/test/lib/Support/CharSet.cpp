@@ -0,0 +1,81 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include <lib/Support/CharSet.hpp>
+#include <test_suite/test_suite.hpp>
+#include <string>
+
+
+namespace mrdocs {
+
+struct CharSet_test
+{
+    void
+    testContains()
+    {
+        constexpr CharSet set("<>&");
+        BOOST_TEST(set.contains('<'));
+        BOOST_TEST(set.contains('&'));
+        BOOST_TEST_NOT(set.contains('a'));
+        BOOST_TEST_NOT(set.contains('\0'));
+        BOOST_TEST(set.chars() == "<>&");
+
+        // Repeated characters are only stored once
+        constexpr CharSet repeated("aab");
+        BOOST_TEST(repeated.chars() == "ab");
+    }
+
+    void
+    testFindFirstOf()
+    {
+        constexpr CharSet set("<>&\n");
+
+        // empty
+        {
+            BOOST_TEST(findFirstOf("", set) == 0);
+        }
+
+        // not found
+        {
+            BOOST_TEST(findFirstOf("abc", set) == 3);
+            std::string const str(100, 'a');
+            BOOST_TEST(findFirstOf(str, set) == str.size());
+        }
+
+        // Every position in strings longer than
+        // the vector blocks, and non-ASCII bytes
+        for (std::size_t size : {1u, 15u, 16u, 17u, 31u, 32u, 33u, 64u, 100u})
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                std::string str(size, '\xE9');
+                str[i] = '&';
+                BOOST_TEST(findFirstOf(str, set) == i);
+                if (i + 1 < size)
+                {
+                    str[size - 1] = '\n';
+                    BOOST_TEST(findFirstOf(str, set) == i);
+                }
+            }
+        }
+    }
+
+    void run()
+    {
+        testContains();
+        testFindFirstOf();
+    }
+};
+
+TEST_SUITE(
+    CharSet_test,
+    "clang.mrdocs.CharSet");
+
+} // mrdocs
@@ -3608,6 +3608,28 @@ helpers()
         BOOST_TEST(hbs.render(string, ctx) == "<a href=\"/root/goodbye\">Goodbye</a>");
     }
 
+    // helper options are complete when visited or modified
+    {
+        dom::Object ctx;
+        ctx.set("value", "world");
+        hbs.registerHelper("options-keys", [](dom::Value const& options) {
+            dom::Object const& obj = options.getObject();
+            BOOST_TEST(obj.exists("name"));
+            BOOST_TEST(obj.exists("data"));
+            BOOST_TEST(obj.exists("hash"));
+            BOOST_TEST(obj.exists("lookupProperty"));
+            std::size_t n = 0;
+            obj.visit([&](dom::String const&, dom::Value const&) { ++n; });
+            BOOST_TEST(n == obj.size());
+            obj.set("extra", "!");
+            obj.set("name", "renamed");
+            return options.get("name") + options.get("extra") +
+                options.get("data").get("root").get("value");
+        });
+        BOOST_TEST(hbs.render("{{options-keys}}", ctx) == "renamed!world");
+        hbs.unregisterHelper("options-keys");
+    }
+
     // helper for raw block gets raw content
     {
         std::string string = "{{{{raw}}}} {{test}} {{{{/raw}}}}";
@@ -5195,6 +5217,19 @@ utils()
             BOOST_TEST(HTMLEscape("foo=") == "foo&#x3D;");
         }
 
+        // should escape characters in long strings
+        {
+            std::string str(70, 'a');
+            str[0] = '<';
+            str[31] = '&';
+            str[69] = '>';
+            std::string expected(str);
+            expected.replace(69, 1, "&gt;");
+            expected.replace(31, 1, "&amp;");
+            expected.replace(0, 1, "&lt;");
+            BOOST_TEST(HTMLEscape(str) == expected);
+        }
+
         // should not escape SafeString
         {
             dom::Value string = safeString("foo<&\"'>");
@@ -5402,7 +5437,231 @@ mustache_compat_spec()
             {
                 return;
             }
+            HandlebarsTemplate compiled = Handlebars::compile(template_str);
+            if (!BOOST_TEST(hbs.render(compiled, context, opt) == expected))
+            {
+                return;
+            }
+        }
+    }
+}
+
+void
+compiled_templates()
+{
+    Handlebars hbs;
+    hbs.registerPartial("item", "  * {{name}}\n");
+    hbs.registerPartial("layout", "<{{> @partial-block }}>");
+    dom::Object ctx;
+    ctx.set("name", "mrdocs");
+    ctx.set("empty", dom::Array{});
+    dom::Array items;
+    for (std::string_view name: {"a", "b", "c"})
+    {
+        dom::Object item;
+        item.set("name", name);
+        items.push_back(item);
+    }
+    ctx.set("items", items);
+
+    // Compiled templates render the same as the template text
+    for (std::string_view text: {
+             "",
+             "no tags",
+             "{{name}}",
+             "{{{name}}} {{&name}} {{ name }}",
+             "\\{{name}} \\\\{{name}} {{",
+             "{{! comment }}{{!-- long {{name}} comment --}}x",
+             "  {{~name~}}  ",
+             "{{#if name}}yes{{else}}no{{/if}}",
+             "{{#if empty}}a{{else if name}}b{{else}}c{{/if}}",
+             "{{^empty}}inverse{{/empty}}",
+             "{{#each items}}{{name}}{{#if @last}}.{{else}}, {{/if}}{{/each}}",
+             "{{#each items as |item i|}}{{i}}:{{item.name}} {{/each}}",
+             "<ul>\n{{#each items}}\n  <li>{{name}}</li>\n{{/each}}\n</ul>\n",
+             "{{#each items}}\n{{> item}}\n{{/each}}",
+             "{{#> layout}}{{name}}{{/layout}}",
+             "{{#*inline \"p\"}}[{{name}}]{{/inline}}{{> p}}",
+             "{{{{raw}}}} {{name}} {{{{/raw}}}}",
+             "{{#with items.[0]}}\n  {{name}}\n{{/with}}\n",
+             "{{#each items}}{{#each ../items}}{{name}}{{/each}}|{{/each}}"})
+    {
+        std::string const expected = hbs.render(text, ctx);
+        HandlebarsTemplate compiled = Handlebars::compile(text);
+        BOOST_TEST(compiled.text() == text);
+        BOOST_TEST(hbs.render(compiled, ctx) == expected);
+        // Render twice to ensure the compiled template is not modified
+        BOOST_TEST(hbs.render(compiled, ctx) == expected);
+    }
+
+    // Errors are the same as the template text
+    {
+        HandlebarsTemplate compiled = Handlebars::compile("{{#if name}}a{{/each}}");
+        BOOST_TEST_NOT(hbs.try_render(compiled, ctx, {}));
+    }
+
+    // The empty template
+    {
+        HandlebarsTemplate compiled;
+        BOOST_TEST(compiled.text().empty());
+        BOOST_TEST(hbs.render(compiled, ctx).empty());
+    }
+
+    // Compiled templates can be shared by environments
+    {
+        HandlebarsTemplate compiled = Handlebars::compile("{{upper name}}");
+        Handlebars other;
+        other.registerHelper("upper", dom::makeVariadicInvocable([](dom::Array const& args) {
+            return toUpperCase(args.get(0).getString().get());
+        }));
+        BOOST_TEST(other.render(compiled, ctx) == "MRDOCS");
+    }
+}
+
+void
+fragment_cache()
+{
+    // Caches partials by the "id" of their context
+    class IdCache : public HandlebarsFragmentCache
+    {
+        std::unordered_map<std::string, std::string> fragments_;
+
+    public:
+        std::string
+        key(
+            std::string_view partialName,
+            dom::Value const& context,
+            dom::Value const&) override
+        {
+            dom::Value id = context.lookup("id");
+            if (!id.isString())
+            {
+                return {};
+            }
+            return std::format("{}:{}", partialName, id.getString().get());
+        }
+
+        std::optional<std::string>
+        find(std::string_view key) override
+        {
+            auto it = fragments_.find(std::string(key));
+            if (it == fragments_.end())
+            {
+                return std::nullopt;
+            }
+            return it->second;
+        }
+
+        void
+        insert(std::string key, std::string fragment) override
+        {
+            fragments_.emplace(std::move(key), std::move(fragment));
+        }
+    };
+
+    Handlebars hbs;
+    int calls = 0;
+    hbs.registerHelper("count", [&calls]() {
+        return ++calls;
+    });
+    hbs.registerPartial("item", "{{name}}{{count}}");
+    hbs.setFragmentCache(std::make_shared<IdCache>());
+
+    dom::Object a;
+    a.set("id", "a");
+    a.set("name", "A");
+    dom::Object b;
+    b.set("id", "b");
+    b.set("name", "B");
+    dom::Object ctx;
+    ctx.set("a", a);
+    ctx.set("b", b);
+
+    // Partials with the same key are rendered once
+    {
+        BOOST_TEST(hbs.render("{{> item a}}{{> item b}}{{> item a}}", ctx) == "A1B2A1");
+        BOOST_TEST(calls == 2);
+    }
+
+    // The cache is shared between renders
+    {
+        BOOST_TEST(hbs.render("{{> item b}}", ctx) == "B2");
+        BOOST_TEST(calls == 2);
+    }
+
+    // Partials with hash arguments are always rendered
+    {
+        BOOST_TEST(hbs.render("{{> item a name='X'}}", ctx) == "X3");
+        BOOST_TEST(calls == 3);
+    }
+
+    // Indented partials are always rendered
+    {
+        BOOST_TEST(hbs.render("  {{> item a}}\n", ctx) == "  A4");
+        BOOST_TEST(calls == 4);
+    }
+
+    // Contexts without a key are always rendered
+    {
+        BOOST_TEST(hbs.render("{{> item}}", ctx) == "5");
+        BOOST_TEST(calls == 5);
+    }
+}
+
+void
+output_buffer()
+{
+    // Writes are collected until the buffer is full
+    {
+        std::string str;
+        {
+            OutputBuffer buf(str, 8);
+            OutputRef out(buf);
+            out << "abc" << 'd';
+            BOOST_TEST(str.empty());
+            out << "efghi";
+            BOOST_TEST(str == "abcd");
+            buf.flush();
+            BOOST_TEST(str == "abcdefghi");
+            out << "j";
+        }
+        BOOST_TEST(str == "abcdefghij");
+    }
+
+    // Large writes go directly to the output
+    {
+        std::string str;
+        OutputBuffer buf(str, 4);
+        OutputRef out(buf);
+        out << "ab";
+        out << "cdefgh";
+        BOOST_TEST(str == "abcdefgh");
+    }
+
+    // Indentation is applied before the buffer
+    {
+        std::string str;
+        {
+            OutputBuffer buf(str);
+            OutputRef out(buf);
+            out.setIndent(2);
+            out << "a\nb\n";
+        }
+        BOOST_TEST(str == "a\n  b\n");
+    }
+
+    // Templates render to the buffer
+    {
+        Handlebars hbs;
+        std::string str;
+        {
+            OutputBuffer buf(str);
+            OutputRef out(buf);
+            dom::Object ctx;
+            ctx.set("name", "<world>");
+            hbs.render_to(out, "Hello {{name}}!", ctx);
         }
+        BOOST_TEST(str == "Hello &lt;world&gt;!");
     }
 }
 
@@ -5436,6 +5695,9 @@ run()
     assume_objects();
     utils();
     mustache_compat_spec();
+    compiled_templates();
+    fragment_cache();
+    output_buffer();
 }
 
 };
@@ -0,0 +1,183 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdocs
+//
+
+#include <lib/Gen/hbs/TemplateStore.hpp>
+#include <lib/Support/HelperPlugin.hpp>
+#include <mrdocs/Support/Handlebars.hpp>
+#include <test_suite/test_suite.hpp>
+#include <string_view>
+
+namespace mrdocs {
+
+namespace {
+int
+add(
+    mrdocs_helper_api const* api,
+    mrdocs_value const* const* args,
+    size_t nargs,
+    mrdocs_value* result)
+{
+    if (nargs < 3)
+    {
+        api->set_string(result, "expected two arguments", 22);
+        return 1;
+    }
+    api->set_integer(result,
+        api->get_integer(args[0]) + api->get_integer(args[1]));
+    return 0;
+}
+
+int
+greet(
+    mrdocs_helper_api const* api,
+    mrdocs_value const* const* args,
+    size_t,
+    mrdocs_value* result)
+{
+    mrdocs_value* name = api->create();
+    api->get_property(args[0], "name", 4, name);
+    std::size_t size = 0;
+    char const* str = api->get_string(name, &size);
+    std::string res = "<b>" + std::string(str, size) + "</b>";
+    api->set_safe_string(result, res.data(), res.size());
+    api->destroy(name);
+    return 0;
+}
+} // (anon)
+
+struct HelperPlugin_test
+{
+    void
+    testIsHelperPlugin()
+    {
+        BOOST_TEST_NOT(isHelperPlugin("helpers/add.js"));
+#if defined(_WIN32)
+        BOOST_TEST(isHelperPlugin("helpers/helpers.dll"));
+#elif defined(__APPLE__)
+        BOOST_TEST(isHelperPlugin("helpers/libhelpers.dylib"));
+#else
+        BOOST_TEST(isHelperPlugin("helpers/libhelpers.so"));
+#endif
+    }
+
+    void
+    testLoad()
+    {
+        BOOST_TEST_NOT(loadHelperPlugin("does-not-exist.so"));
+    }
+
+    void
+    testNativeHelper()
+    {
+        Handlebars hbs;
+        hbs.registerHelper("add", makeNativeHelper({"add", &add}));
+        hbs.registerHelper("greet", makeNativeHelper({"greet", &greet}));
+
+        dom::Object person;
+        person.set("name", "World");
+        dom::Object ctx;
+        ctx.set("person", person);
+
+        BOOST_TEST(hbs.render("{{add 1 2}}", ctx) == "3");
+        BOOST_TEST(hbs.render("{{greet person}}", ctx) == "<b>World</b>");
+
+        // Errors are reported with the helper name
+        dom::Array args;
+        args.emplace_back(1);
+        auto exp = makeNativeHelper({"add", &add}).call(args);
+        BOOST_TEST_NOT(exp);
+        if (!exp)
+        {
+            BOOST_TEST(exp.error().reason() == "add: expected two arguments");
+        }
+    }
+
+    static
+    void
+    testRender(std::vector<NativeHelper> const& helpers)
+    {
+        Handlebars hbs;
+        for (NativeHelper const& helper : helpers)
+        {
+            hbs.registerHelper(helper.name, makeNativeHelper(helper));
+        }
+        BOOST_TEST(hbs.hasHelper("plugin_add"));
+        BOOST_TEST(hbs.hasHelper("plugin_bold"));
+
+        dom::Object person;
+        person.set("name", "World");
+        dom::Object ctx;
+        ctx.set("person", person);
+        ctx.set("n", 40);
+
+        BOOST_TEST(
+            hbs.render("{{plugin_add n 2}} {{plugin_bold person}}", ctx) ==
+            "42 <b>World</b>");
+
+        // Errors reported by the plugin
+        auto exp = hbs.try_render("{{plugin_bold n}}", ctx);
+        BOOST_TEST_NOT(exp);
+    }
+
+    void
+    testPlugin()
+    {
+        auto helpers = loadHelperPlugin(MRDOCS_TEST_HELPER_PLUGIN);
+        BOOST_TEST(helpers);
+        if (!helpers)
+        {
+            return;
+        }
+        BOOST_TEST(helpers->size() == 2);
+        testRender(*helpers);
+    }
+
+    void
+    testTemplateStore()
+    {
+        // Plugins are loaded from the helpers directory
+        {
+            auto helpers = hbs::TemplateStore::loadHelperPlugins(
+                MRDOCS_TEST_HELPER_PLUGIN_DIR);
+            BOOST_TEST(helpers);
+            if (helpers)
+            {
+                BOOST_TEST(helpers->size() == 2);
+                testRender(*helpers);
+            }
+        }
+
+        // Directories without plugins have no native helpers
+        {
+            auto helpers = hbs::TemplateStore::loadHelperPlugins(
+                MRDOCS_TEST_FILES_DIR);
+            BOOST_TEST(helpers);
+            if (helpers)
+            {
+                BOOST_TEST(helpers->empty());
+            }
+        }
+    }
+
+    void run()
+    {
+        testIsHelperPlugin();
+        testLoad();
+        testNativeHelper();
+        testPlugin();
+        testTemplateStore();
+    }
+};
+
+TEST_SUITE(
+    HelperPlugin_test,
+    "clang.mrdocs.HelperPlugin");
+
+} // mrdocs
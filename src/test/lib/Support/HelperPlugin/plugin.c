@@ -0,0 +1,89 @@
+/*
+    Licensed under the Apache License v2.0 with LLVM Exceptions.
+    See https://llvm.org/LICENSE.txt for license information.
+    SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+    Copyright (c) 2024 Alan de Freitas (alandefreitas@gmail.com)
+
+    Official repository: https://github.com/cppalliance/mrdocs
+*/
+
+/*  A native helper plugin used by the unit tests
+
+    The plugin is written in C so the tests also
+    check that the interface doesn't depend on C++.
+*/
+
+#include <mrdocs/Support/HelperPlugin.hpp>
+#include <string.h>
+
+static
+int
+plugin_add(
+    mrdocs_helper_api const* api,
+    mrdocs_value const* const* args,
+    size_t nargs,
+    mrdocs_value* result)
+{
+    static char const msg[] = "expected two arguments";
+    if (nargs < 3)
+    {
+        api->set_string(result, msg, sizeof(msg) - 1);
+        return 1;
+    }
+    api->set_integer(result,
+        api->get_integer(args[0]) + api->get_integer(args[1]));
+    return 0;
+}
+
+static
+int
+plugin_bold(
+    mrdocs_helper_api const* api,
+    mrdocs_value const* const* args,
+    size_t nargs,
+    mrdocs_value* result)
+{
+    char buf[256];
+    size_t size = 0;
+    char const* str;
+    mrdocs_value* name;
+    if (nargs < 2 || api->kind(args[0]) != MRDOCS_VALUE_OBJECT)
+    {
+        static char const msg[] = "expected an object";
+        api->set_string(result, msg, sizeof(msg) - 1);
+        return 1;
+    }
+    name = api->create();
+    api->get_property(args[0], "name", 4, name);
+    str = api->get_string(name, &size);
+    if (size > sizeof(buf) - 7)
+    {
+        size = sizeof(buf) - 7;
+    }
+    memcpy(buf, "<b>", 3);
+    if (str)
+    {
+        memcpy(buf + 3, str, size);
+    }
+    memcpy(buf + 3 + size, "</b>", 4);
+    api->set_safe_string(result, buf, size + 7);
+    api->destroy(name);
+    return 0;
+}
+
+MRDOCS_HELPER_PLUGIN_EXPORT
+int
+mrdocs_register_helpers(
+    unsigned version,
+    void* registry,
+    mrdocs_register_helper_fn register_helper)
+{
+    if (version != MRDOCS_HELPER_PLUGIN_VERSION)
+    {
+        return 1;
+    }
+    register_helper(registry, "plugin_add", &plugin_add);
+    register_helper(registry, "plugin_bold", &plugin_bold);
+    return 0;
+}